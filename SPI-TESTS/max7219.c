@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ws2812_clock.h"
+#include "ws2812_spi.h"
+
+// Scroll a message across cascaded MAX7219 8x8 matrices, as matrix.py does
+// through luma, in C on the batched SPI path ( ws2812_spi.h ).
+//
+//   ./build/max7219 [-d device] [-n matrices] [-i intensity] [-f fps] [-l] [-a] [text]
+//
+//   ./build/max7219 "Hello world!"              # once across one matrix
+//   ./build/max7219 -n 4 -l -f 30 "Pico Max"    # four in a row, forever
+//   ./build/max7219 -d mock: -a Hi              # no board: frames as ASCII
+//
+// A MAX7219 register write is 16 bits per matrix shifted through the whole
+// cascade and latched when chip select goes high, so a frame - the eight
+// row registers - is eight transfers with a chip-select pulse after each.
+// They go out as one SPI_IOC_MESSAGE(8) rather than eight ioctls.
+//
+// Matrix 0 is the one wired to the board and shows the left of the text;
+// bit 7 of a row is its leftmost column ( FC-16 style modules ).
+//
+// Build: make build/max7219 from the top of the repo
+
+#define MAX_MATRICES 16
+
+// MAX7219 registers
+#define REG_DIGIT0      0x01    // rows are digits 0-7
+#define REG_DECODE_MODE 0x09
+#define REG_INTENSITY   0x0A
+#define REG_SCAN_LIMIT  0x0B
+#define REG_SHUTDOWN    0x0C
+#define REG_TEST        0x0F
+
+#define SPEED_HZ 1000000        // the chip takes up to 10 MHz; 1 MHz forgives long wires
+
+// 5x7 font, ' ' to '~': five columns a character, bit 0 the top row
+static const uint8_t font[95][5] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},
+    {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x56,0x20,0x50}, {0x00,0x08,0x07,0x03,0x00},
+    {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08},
+    {0x00,0x80,0x70,0x30,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x00,0x60,0x60,0x00}, {0x20,0x10,0x08,0x04,0x02},
+    {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x72,0x49,0x49,0x49,0x46}, {0x21,0x41,0x49,0x4D,0x33},
+    {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x31}, {0x41,0x21,0x11,0x09,0x07},
+    {0x36,0x49,0x49,0x49,0x36}, {0x46,0x49,0x49,0x29,0x1E}, {0x00,0x00,0x14,0x00,0x00}, {0x00,0x40,0x34,0x00,0x00},
+    {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x59,0x09,0x06},
+    {0x3E,0x41,0x5D,0x59,0x4E}, {0x7C,0x12,0x11,0x12,0x7C}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+    {0x7F,0x41,0x41,0x41,0x3E}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x41,0x51,0x73},
+    {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},
+    {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x1C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x26,0x49,0x49,0x49,0x32},
+    {0x03,0x01,0x7F,0x01,0x03}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F},
+    {0x63,0x14,0x08,0x14,0x63}, {0x03,0x04,0x78,0x04,0x03}, {0x61,0x59,0x49,0x4D,0x43}, {0x00,0x7F,0x41,0x41,0x41},
+    {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x41,0x7F}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},
+    {0x00,0x03,0x07,0x08,0x00}, {0x20,0x54,0x54,0x78,0x40}, {0x7F,0x28,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x28},
+    {0x38,0x44,0x44,0x28,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x00,0x08,0x7E,0x09,0x02}, {0x18,0xA4,0xA4,0x9C,0x78},
+    {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x40,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00},
+    {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x78,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},
+    {0xFC,0x18,0x24,0x24,0x18}, {0x18,0x24,0x24,0x18,0xFC}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x24},
+    {0x04,0x04,0x3F,0x44,0x24}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},
+    {0x44,0x28,0x10,0x28,0x44}, {0x4C,0x90,0x90,0x90,0x7C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},
+    {0x00,0x00,0x77,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x02,0x01,0x02,0x04,0x02},
+};
+
+static int matrices = 1;
+
+// The same register of every matrix, set from values[matrix], as one
+// transfer: the first bytes out end up in the matrix furthest down the chain
+static void queue_write(struct ws2812_spi *spi, uint8_t *buf, uint8_t reg, const uint8_t *values) {
+    for (int m = 0; m < matrices; m++) {
+        buf[2 * m] = reg;
+        buf[2 * m + 1] = values[matrices - 1 - m];
+    }
+    struct ws2812_spi_xfer x = {
+        .tx = buf, .len = (uint32_t)(2 * matrices), .speed_hz = SPEED_HZ, .bits_per_word = 8, .cs_change = 1,
+    };
+    ws2812_spi_add(spi, &x);
+}
+
+static int write_all(struct ws2812_spi *spi, uint8_t reg, uint8_t value) {
+    uint8_t buf[2 * MAX_MATRICES], values[MAX_MATRICES];
+    memset(values, value, sizeof(values));
+    queue_write(spi, buf, reg, values);
+    return ws2812_spi_flush(spi);
+}
+
+int main(int argc, char *argv[]) {
+    const char *device = "/dev/spidev0.0";
+    int intensity = 4, fps = 20, loop = 0, ascii = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:n:i:f:la")) != -1) {
+        switch (opt) {
+            case 'd': device = optarg; break;
+            case 'n': matrices = atoi(optarg); break;
+            case 'i': intensity = atoi(optarg); break;
+            case 'f': fps = atoi(optarg); break;
+            case 'l': loop = 1; break;
+            case 'a': ascii = 1; break;
+            default:
+                fprintf(stderr, "Usage: %s [-d device] [-n matrices] [-i intensity] [-f fps] [-l] [-a] [text]\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+    const char *text = optind < argc ? argv[optind] : "Hello world!";
+    if (matrices < 1 || matrices > MAX_MATRICES || intensity < 0 || intensity > 15 || fps < 1) {
+        fprintf(stderr, "1-%d matrices, intensity 0-15, fps > 0\n", MAX_MATRICES);
+        return 1;
+    }
+
+    struct ws2812_spi spi;
+    if (ws2812_spi_open(&spi, device) < 0) {
+        perror("Failed to open SPI device");
+        return 1;
+    }
+
+    // Raw rows, no BCD decoding, all eight rows scanned, out of shutdown
+    if (write_all(&spi, REG_TEST, 0) < 0 || write_all(&spi, REG_DECODE_MODE, 0) < 0 ||
+        write_all(&spi, REG_SCAN_LIMIT, 7) < 0 || write_all(&spi, REG_INTENSITY, (uint8_t)intensity) < 0 ||
+        write_all(&spi, REG_SHUTDOWN, 1) < 0) {
+        perror("Failed to set up the MAX7219");
+        ws2812_spi_close(&spi);
+        return 1;
+    }
+    uint64_t setup_messages = spi.messages;
+
+    // The text as columns, with a blank display's width either side so it
+    // scrolls in from the right and all the way out to the left
+    int width = 8 * matrices;
+    int len = (int)strlen(text);
+    int columns = 2 * width + 6 * len;
+    uint8_t *strip = calloc((size_t)columns, 1);
+    if (strip == NULL) {
+        perror("calloc");
+        return 1;
+    }
+    for (int i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c < ' ' || c > '~') c = '?';
+        memcpy(strip + width + 6 * i, font[c - ' '], 5);
+    }
+
+    struct ws2812_clock clk;
+    ws2812_clock_init(&clk, 1000000 / fps);
+
+    uint8_t bufs[8][2 * MAX_MATRICES];
+    uint64_t frames = 0;
+    for (int scroll = 0; loop || scroll <= columns - width; scroll = (scroll + 1) % (columns - width + 1)) {
+        // Row r of matrix m: bit 7 is its left column
+        for (int r = 0; r < 8; r++) {
+            uint8_t row[MAX_MATRICES];
+            for (int m = 0; m < matrices; m++) {
+                row[m] = 0;
+                for (int c = 0; c < 8; c++) {
+                    if ((strip[scroll + 8 * m + c] >> r) & 1) row[m] |= 0x80 >> c;
+                }
+            }
+            queue_write(&spi, bufs[r], (uint8_t)(REG_DIGIT0 + r), row);
+
+            if (ascii) {
+                for (int m = 0; m < matrices; m++) {
+                    for (int c = 0; c < 8; c++) putchar(row[m] & (0x80 >> c) ? '#' : '.');
+                }
+                putchar('\n');
+            }
+        }
+        if (ascii) putchar('\n');
+
+        // Eight row writes, one message
+        if (ws2812_spi_flush(&spi) < 0) {
+            perror("SPI transfer failed");
+            break;
+        }
+        frames++;
+        if (!loop && scroll == columns - width) break;
+        ws2812_clock_wait(&clk);
+    }
+
+    printf("%llu frames in %llu SPI messages ( %llu transfers )\n", (unsigned long long)frames,
+           (unsigned long long)(spi.messages - setup_messages), (unsigned long long)(spi.transfers - 5));
+    free(strip);
+    ws2812_spi_close(&spi);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Microbenchmark: float ws2812_hsv_to_rgb() vs the fixed-point hue kernel.
+// Renders the same rainbow frame both ways and prints ns per pixel.
+//
+//   ./build/color-bench [-n leds] [-i iterations] [-b brightness]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ws2812_color.h"
+
+static double now_sec(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+// What the rainbow programs did per pixel before the fixed-point kernel
+static void render_float(uint8_t *grb, int count, uint8_t hue, float brightness) {
+    for (int i = 0; i < count; i++) {
+        uint8_t r, g, b;
+        ws2812_hsv_to_rgb(hue + (i * 5), brightness, &r, &g, &b);
+        grb[i * 3]     = g;
+        grb[i * 3 + 1] = r;
+        grb[i * 3 + 2] = b;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int leds = 4096;
+    int iterations = 1000;
+    float brightness = 0.5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:i:b:")) != -1) {
+        switch (opt) {
+            case 'n': leds = atoi(optarg); break;
+            case 'i': iterations = atoi(optarg); break;
+            case 'b': brightness = atof(optarg); break;
+            default: fprintf(stderr, "Usage: %s [-n leds] [-i iterations] [-b brightness]\n", argv[0]); return 1;
+        }
+    }
+    if (leds <= 0 || iterations <= 0) { fprintf(stderr, "leds and iterations must be > 0\n"); return 1; }
+
+    uint8_t *a = malloc(leds * 3);
+    uint8_t *b = malloc(leds * 3);
+    if (a == NULL || b == NULL) { perror("malloc"); return 1; }
+
+    uint8_t level = ws2812_brightness_level(brightness);
+    unsigned sink = 0;
+
+    double t0 = now_sec();
+    for (int it = 0; it < iterations; it++) {
+        render_float(a, leds, (uint8_t)it, brightness);
+        sink += a[it % (leds * 3)];
+    }
+    double t_float = now_sec() - t0;
+
+    t0 = now_sec();
+    for (int it = 0; it < iterations; it++) {
+        ws2812_hue_fill(b, leds, (uint8_t)it, 5, level);
+        sink += b[it % (leds * 3)];
+    }
+    double t_fixed = now_sec() - t0;
+
+    // Same frame both ways: how far apart are they?
+    render_float(a, leds, 0, brightness);
+    ws2812_hue_fill(b, leds, 0, 5, level);
+    int max_diff = 0;
+    for (int i = 0; i < leds * 3; i++) {
+        int d = abs(a[i] - b[i]);
+        if (d > max_diff) max_diff = d;
+    }
+
+    double px = (double)leds * iterations;
+    printf("%d LEDs x %d frames, brightness %.2f (level %u)\n", leds, iterations, brightness, level);
+    printf("  float hsv_to_rgb : %7.2f ns/pixel\n", t_float * 1e9 / px);
+    printf("  fixed hue_fill   : %7.2f ns/pixel  (%.1fx)\n", t_fixed * 1e9 / px, t_float / t_fixed);
+    printf("  max channel diff : %d\n", max_diff);
+
+    free(a);
+    free(b);
+    return sink == 0xFFFFFFFF; // keep the loops from being optimized away
+}
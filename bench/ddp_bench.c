@@ -0,0 +1,190 @@
+// DDP ingest benchmark: a receiver thread ( the same recvmmsg + apply loop as
+// ws2812d -u ) against a sender in the same process over loopback.
+//
+//   ./build/ddp-bench [-p port] [-f frames] [leds ...]
+//
+// For each LED count it reports frame latency ( first packet sent -> PUSH
+// applied, one frame in flight ) and then blasts frames for a second to
+// measure packets and frames per second and how many were lost.
+#define _GNU_SOURCE     // sendmmsg()
+#include <semaphore.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "ws2812.h"
+#include "ws2812_ddp.h"
+
+#define MAX_PACKETS 64
+
+static const int default_counts[] = { 64, 512, 2048, 8192 };
+
+struct receiver {
+    struct ws2812_ddp ddp;
+    uint8_t *grb;
+    size_t led_count;
+    atomic_bool stop;
+    sem_t pushed;
+};
+
+static double now_us(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void *receiver_main(void *arg) {
+    struct receiver *rx = arg;
+
+    while (!atomic_load(&rx->stop)) {
+        int n = ws2812_ddp_receive(&rx->ddp, 10);
+        for (int i = 0; i < n; i++) {
+            if (ws2812_ddp_apply(&rx->ddp, i, rx->grb, rx->led_count) > 0) sem_post(&rx->pushed);
+        }
+    }
+    return NULL;
+}
+
+// Packets for one frame, ready for sendmmsg(). Returns how many.
+static int build_frame(uint8_t (*pkt)[WS2812_DDP_HEADER_LEN + WS2812_DDP_MAX_DATA], struct iovec *iov,
+                       struct mmsghdr *msgs, struct sockaddr_in *addr, const uint8_t *rgb, size_t len) {
+    int n = 0;
+    for (size_t off = 0; off < len; off += WS2812_DDP_MAX_DATA, n++) {
+        size_t chunk = len - off < WS2812_DDP_MAX_DATA ? len - off : WS2812_DDP_MAX_DATA;
+        iov[n].iov_base = pkt[n];
+        iov[n].iov_len = ws2812_ddp_pack(pkt[n], 1, (uint32_t)off, rgb + off, chunk, off + chunk == len);
+        memset(&msgs[n], 0, sizeof(msgs[n]));
+        msgs[n].msg_hdr.msg_name = addr;
+        msgs[n].msg_hdr.msg_namelen = sizeof(*addr);
+        msgs[n].msg_hdr.msg_iov = &iov[n];
+        msgs[n].msg_hdr.msg_iovlen = 1;
+    }
+    return n;
+}
+
+int main(int argc, char *argv[]) {
+    int port = WS2812_DDP_PORT + 1;     // stays clear of a running ws2812d
+    int frames = 1000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:f:")) != -1) {
+        switch (opt) {
+            case 'p': port = atoi(optarg); break;
+            case 'f': frames = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-p port] [-f frames] [leds ...]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (frames <= 0) { fprintf(stderr, "frames must be > 0\n"); return 1; }
+
+    int ncounts = argc - optind;
+    int counts[64];
+    if (ncounts == 0) {
+        ncounts = sizeof(default_counts) / sizeof(default_counts[0]);
+        for (int i = 0; i < ncounts; i++) counts[i] = default_counts[i];
+    } else {
+        if (ncounts > 64) ncounts = 64;
+        for (int i = 0; i < ncounts; i++) counts[i] = atoi(argv[optind + i]);
+    }
+
+    static struct receiver rx;
+    if (ws2812_ddp_open(&rx.ddp, port) < 0) { perror("Can't open UDP port"); return 1; }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    static uint8_t pkt[MAX_PACKETS][WS2812_DDP_HEADER_LEN + WS2812_DDP_MAX_DATA];
+    struct mmsghdr msgs[MAX_PACKETS];
+    struct iovec iov[MAX_PACKETS];
+    double *latency = malloc(frames * sizeof(double));
+    if (fd < 0 || latency == NULL) { perror("setup"); return 1; }
+
+    printf("DDP over loopback, port %d, %d frames per size, %d packets per recvmmsg\n",
+           port, frames, WS2812_DDP_BATCH);
+
+    for (int c = 0; c < ncounts; c++) {
+        size_t leds = counts[c];
+        size_t len = leds * 3;
+        if (leds == 0 || (len + WS2812_DDP_MAX_DATA - 1) / WS2812_DDP_MAX_DATA > MAX_PACKETS) continue;
+
+        uint8_t *rgb = malloc(len);
+        rx.grb = calloc(leds, 3);
+        rx.led_count = leds;
+        if (rgb == NULL || rx.grb == NULL) { perror("malloc"); return 1; }
+        ws2812_hue_fill(rgb, leds, 0, 5, 255);
+        int n = build_frame(pkt, iov, msgs, &addr, rgb, len);
+
+        atomic_store(&rx.stop, 0);
+        sem_init(&rx.pushed, 0, 0);
+        memset(&rx.ddp.stats, 0, sizeof(rx.ddp.stats));
+        pthread_t thread;
+        pthread_create(&thread, NULL, receiver_main, &rx);
+
+        // Latency: one frame in flight at a time
+        int lost = 0;
+        for (int f = 0; f < frames; f++) {
+            double t0 = now_us();
+            sendmmsg(fd, msgs, n, 0);
+
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += 100000000;
+            if (deadline.tv_nsec >= 1000000000) { deadline.tv_sec++; deadline.tv_nsec -= 1000000000; }
+            if (sem_timedwait(&rx.pushed, &deadline) < 0) { lost++; latency[f] = 1e5; continue; }
+            latency[f] = now_us() - t0;
+        }
+        qsort(latency, frames, sizeof(*latency), cmp_double);
+
+        // Throughput: send as fast as the socket takes it for one second
+        struct ws2812_ddp_stats before = rx.ddp.stats;
+        long sent = 0;
+        double start = now_us();
+        while (now_us() - start < 1e6) {
+            int k = sendmmsg(fd, msgs, n, 0);
+            if (k > 0) sent += k;
+        }
+        usleep(100000);     // let the receiver drain
+        double secs = (now_us() - start) / 1e6;
+        atomic_store(&rx.stop, 1);
+        pthread_join(thread, NULL);
+        while (sem_trywait(&rx.pushed) == 0) {
+        }
+
+        uint64_t got = rx.ddp.stats.packets - before.packets;
+        uint64_t got_frames = rx.ddp.stats.frames - before.frames;
+        uint64_t batches = rx.ddp.stats.batches - before.batches;
+
+        printf("%zu LEDs (%d packet%s/frame)\n", leds, n, n > 1 ? "s" : "");
+        printf("  latency  p50 %8.1f  p99 %8.1f  max %8.1f us%s\n", latency[frames / 2],
+               latency[(frames * 99) / 100], latency[frames - 1], lost ? "  (frames lost)" : "");
+        printf("  blast    %9.0f packets/s  %8.0f frames/s  %5.1f packets/batch  %4.1f%% lost\n",
+               got / secs, got_frames / secs, batches ? (double)got / batches : 0.0,
+               sent ? 100.0 * (sent - (long)got) / sent : 0.0);
+
+        sem_destroy(&rx.pushed);
+        free(rx.grb);
+        free(rgb);
+    }
+
+    ws2812_ddp_close(&rx.ddp);
+    close(fd);
+    free(latency);
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Benchmark: whole-frame kernels in this build ( NEON or scalar ) against
+// the scalar reference, and check they produce the same bytes.
+//
+//   ./build/frame-bench [-n leds] [-i iterations]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ws2812_frame.h"
+
+static double now_sec(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static int leds = 4096;
+static int iterations = 1000;
+static uint8_t *frame, *frame_ref, *spi, *spi_ref;
+static uint8_t gamma_lut[256];
+
+static void fill_random(void) {
+    for (int i = 0; i < leds * 3; i++) frame[i] = frame_ref[i] = (uint8_t)rand();
+}
+
+static void report(const char *name, double t_fast, double t_ref, int same) {
+    double n = (double)leds * iterations;
+    printf("  %-12s %7.2f ns/LED  scalar %7.2f ns/LED  (%.1fx)  %s\n",
+           name, t_fast * 1e9 / n, t_ref * 1e9 / n, t_ref / t_fast, same ? "match" : "MISMATCH");
+}
+
+// Time 'fast' and 'ref' over the same input, then compare one run of each
+#define BENCH(name, fast, ref, out, out_ref, out_len)               \
+    do {                                                            \
+        fill_random();                                              \
+        double t0 = now_sec();                                      \
+        for (int it = 0; it < iterations; it++) { fast; }           \
+        double t_fast = now_sec() - t0;                             \
+        t0 = now_sec();                                             \
+        for (int it = 0; it < iterations; it++) { ref; }            \
+        double t_ref = now_sec() - t0;                              \
+        fill_random();                                              \
+        fast;                                                       \
+        ref;                                                        \
+        int same = memcmp(out, out_ref, out_len) == 0;              \
+        report(name, t_fast, t_ref, same);                          \
+        failures += !same;                                          \
+    } while (0)
+
+int main(int argc, char *argv[]) {
+    int opt;
+    while ((opt = getopt(argc, argv, "n:i:")) != -1) {
+        switch (opt) {
+            case 'n': leds = atoi(optarg); break;
+            case 'i': iterations = atoi(optarg); break;
+            default: fprintf(stderr, "Usage: %s [-n leds] [-i iterations]\n", argv[0]); return 1;
+        }
+    }
+    if (leds <= 0 || iterations <= 0) { fprintf(stderr, "leds and iterations must be > 0\n"); return 1; }
+
+    frame = malloc(leds * 3);
+    frame_ref = malloc(leds * 3);
+    spi = malloc(leds * 3 * 8);
+    spi_ref = malloc(leds * 3 * 8);
+    if (!frame || !frame_ref || !spi || !spi_ref) { perror("malloc"); return 1; }
+
+    // Rough gamma 2.0 curve, just something that is not the identity
+    for (int i = 0; i < 256; i++) gamma_lut[i] = (uint8_t)((i * i + 254) / 255);
+
+    int failures = 0;
+    printf("%d LEDs x %d frames, %s kernels\n", leds, iterations, ws2812_simd_name());
+
+    BENCH("rgb_to_grb", ws2812_rgb_to_grb(frame, frame, leds),
+          ws2812_rgb_to_grb_scalar(frame_ref, frame_ref, leds), frame, frame_ref, leds * 3);
+    BENCH("scale", ws2812_scale_frame(frame, leds * 3, 77),
+          ws2812_scale_frame_scalar(frame_ref, leds * 3, 77), frame, frame_ref, leds * 3);
+    BENCH("gamma lut", ws2812_lut_frame(frame, leds * 3, gamma_lut),
+          ws2812_lut_frame_scalar(frame_ref, leds * 3, gamma_lut), frame, frame_ref, leds * 3);
+    static uint8_t lut3[3][256];
+    for (int c = 0; c < 3; c++)
+        for (int i = 0; i < 256; i++) lut3[c][i] = gamma_lut[(i + c * 40) & 0xFF];
+    BENCH("lut per chan", ws2812_lut3_frame(frame, frame, leds, (const uint8_t (*)[256])lut3),
+          ws2812_lut3_frame_scalar(frame_ref, frame_ref, leds, (const uint8_t (*)[256])lut3), frame, frame_ref, leds * 3);
+    BENCH("encode", ws2812_encode(spi, frame, leds * 3),
+          ws2812_encode_scalar(spi_ref, frame, leds * 3), spi, spi_ref, leds * 3 * 8);
+
+    free(frame);
+    free(frame_ref);
+    free(spi);
+    free(spi_ref);
+    return failures ? 1 : 0;
+}
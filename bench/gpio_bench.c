@@ -0,0 +1,167 @@
+// Benchmark: how fast one GPIO pin can be toggled through each backend -
+// the sysfs value file pin.c used to write, a character-device line request
+// ( gpio_lines.h ) and mmap'ed controller registers ( gpio_mmio.h ).
+//
+//   ./build/gpio-bench [-p pin] [-n toggles]        on the board
+//   ./build/gpio-bench -f                           fake backends, for CI
+//
+// On the board the pin must be free; sysfs needs it exported ( the bench
+// exports and unexports it ), mmap needs root and GPIO_ALLOW_DEVMEM=1.
+// With -f sysfs writes go to a plain file, the chardev backend is the
+// in-memory mock chip and mmap stores land in a fake register file, so the
+// numbers only show the cost of each path's user-space side.
+// A backend that cannot be opened is reported and skipped.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gpio_lines.h"
+#include "gpio_mmio.h"
+
+static double now_sec(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static int pin = 55;
+static long toggles = 100000;
+static int fake;
+
+static void report(const char *name, const char *how, double t) {
+    printf("  %-8s %12.0f toggles/s  %9.1f ns/toggle  (%s)\n", name, toggles / t, t * 1e9 / toggles, how);
+}
+
+static int write_sysfs(const char *path, const char *value) {
+    int fd = open(path, O_WRONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    ssize_t n = write(fd, value, strlen(value));
+    int err = errno;
+    close(fd);
+    errno = err;
+    return n < 0 ? -1 : 0;
+}
+
+// One write() of "1" or "0" per edge, as fprintf + fflush did in pin.c
+static void bench_sysfs(void) {
+    char value_path[64], number[16];
+    int exported = 0;
+    snprintf(number, sizeof(number), "%d", pin);
+
+    if (fake) {
+        snprintf(value_path, sizeof(value_path), "/tmp/gpio-bench-value");
+    } else {
+        snprintf(value_path, sizeof(value_path), "/sys/class/gpio/gpio%d/value", pin);
+        if (access(value_path, F_OK) != 0) {
+            if (write_sysfs("/sys/class/gpio/export", number) < 0) {
+                printf("  %-8s skipped: can't export gpio%d: %s\n", "sysfs", pin, strerror(errno));
+                return;
+            }
+            exported = 1;
+        }
+        char dir_path[64];
+        snprintf(dir_path, sizeof(dir_path), "/sys/class/gpio/gpio%d/direction", pin);
+        write_sysfs(dir_path, "out");
+    }
+
+    int fd = open(value_path, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        printf("  %-8s skipped: %s: %s\n", "sysfs", value_path, strerror(errno));
+    } else {
+        double t0 = now_sec();
+        for (long i = 0; i < toggles; i++) {
+            if (pwrite(fd, i & 1 ? "0" : "1", 1, 0) < 0) break;
+        }
+        report("sysfs", value_path, now_sec() - t0);
+        close(fd);
+    }
+
+    if (exported) write_sysfs("/sys/class/gpio/unexport", number);
+    if (fake) unlink(value_path);
+}
+
+// One GPIO_V2_LINE_SET_VALUES ioctl per edge
+static void bench_chardev(void) {
+    char chip[64];
+    unsigned offset;
+    if (fake) {
+        snprintf(chip, sizeof(chip), GPIO_MOCK_CHIP);
+        offset = (unsigned)pin % 32;
+    } else if (gpio_line_from_number(pin, chip, sizeof(chip), &offset) < 0) {
+        printf("  %-8s skipped: %s\n", "chardev", strerror(errno));
+        return;
+    }
+
+    struct gpio_lines lines;
+    if (gpio_lines_request(&lines, chip, &offset, 1, GPIO_OUTPUT, 0, "gpio-bench") < 0) {
+        printf("  %-8s skipped: %s: %s\n", "chardev", chip, strerror(errno));
+        return;
+    }
+
+    double t0 = now_sec();
+    for (long i = 0; i < toggles; i++) {
+        if (gpio_lines_set(&lines, 1, ~i & 1) < 0) break;
+    }
+    char how[96];
+    snprintf(how, sizeof(how), "%s line %u", chip, offset);
+    report("chardev", how, now_sec() - t0);
+    gpio_lines_release(&lines);
+}
+
+// One store per edge
+static void bench_mmap(void) {
+    const char *path = fake ? "/tmp/gpio-bench-regs" : "/dev/mem";
+    unsigned bank = (unsigned)pin / 32;
+    uint32_t bit = 1u << (pin % 32);
+
+    if (fake) close(open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644));
+
+    struct gpio_mmio m;
+    if (gpio_mmio_open(&m, bank, path) < 0) {
+        printf("  %-8s skipped: %s: %s%s\n", "mmap", path, strerror(errno),
+               errno == EPERM ? " (set GPIO_ALLOW_DEVMEM=1, run as root)" : "");
+        return;
+    }
+    gpio_mmio_direction(&m, bit, 1);
+
+    double t0 = now_sec();
+    for (long i = 0; i < toggles; i++) {
+        if (i & 1) {
+            gpio_mmio_clear(&m, bit);
+        } else {
+            gpio_mmio_set(&m, bit);
+        }
+    }
+    char how[96];
+    snprintf(how, sizeof(how), "%s bank %u", path, bank);
+    report("mmap", how, now_sec() - t0);
+
+    gpio_mmio_clear(&m, bit);
+    gpio_mmio_close(&m);
+    if (fake) unlink(path);
+}
+
+int main(int argc, char *argv[]) {
+    int opt;
+    while ((opt = getopt(argc, argv, "p:n:f")) != -1) {
+        switch (opt) {
+            case 'p': pin = atoi(optarg); break;
+            case 'n': toggles = atol(optarg); break;
+            case 'f': fake = 1; break;
+            default: fprintf(stderr, "Usage: %s [-p pin] [-n toggles] [-f]\n", argv[0]); return 1;
+        }
+    }
+    if (pin < 0 || toggles < 1) { fprintf(stderr, "Bad pin or toggle count\n"); return 1; }
+
+    printf("gpio%d, %ld toggles%s\n", pin, toggles, fake ? ", fake backends" : "");
+    bench_sysfs();
+    bench_chardev();
+    bench_mmap();
+    return 0;
+}
@@ -0,0 +1,131 @@
+// End-to-end frame benchmark: render, encode and transmit time per frame
+// for a sweep of LED counts. Runs off the board against the mock transport
+// ( the default ) and on the board against the real spidev node.
+//
+//   ./build/pipeline-bench [-d device] [-m 8|4|3] [-f frames] [-g gamma] [leds ...]
+//
+//   ./build/pipeline-bench                      # mock:, 64 .. 4096 LEDs
+//   ./build/pipeline-bench -d null:             # no decode: pure library cost
+//   ./build/pipeline-bench -d /dev/spidev0.0 64 128
+//   ./build/pipeline-bench -d /dev/spidev0.0,/dev/spidev1.0 4096   # two buses
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ws2812.h"
+#include "ws2812_multi.h"
+
+static const int default_counts[] = { 64, 128, 256, 512, 1024, 2048, 4096 };
+
+static double now_us(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Sorts v
+static void print_stage(const char *name, double *v, int n) {
+    double sum = 0;
+    for (int i = 0; i < n; i++) sum += v[i];
+    qsort(v, n, sizeof(*v), cmp_double);
+    printf("  %-9s avg %9.1f  p50 %9.1f  p99 %9.1f  max %9.1f us\n",
+           name, sum / n, v[n / 2], v[(n * 99) / 100], v[n - 1]);
+}
+
+int main(int argc, char *argv[]) {
+    const char *device = "mock:";
+    enum ws2812_mode mode = WS2812_MODE_8BIT;
+    int frames = 500;
+    float gamma = 1.0f;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:m:f:g:")) != -1) {
+        switch (opt) {
+            case 'd': device = optarg; break;
+            case 'm':
+                if (ws2812_parse_mode(optarg, &mode) < 0) { fprintf(stderr, "Mode must be 8, 4 or 3\n"); return 1; }
+                break;
+            case 'f': frames = atoi(optarg); break;
+            case 'g': gamma = atof(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-d device] [-m 8|4|3] [-f frames] [-g gamma] [leds ...]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (frames <= 0) { fprintf(stderr, "frames must be > 0\n"); return 1; }
+
+    int ncounts = argc - optind;
+    int counts[64];
+    if (ncounts == 0) {
+        ncounts = sizeof(default_counts) / sizeof(default_counts[0]);
+        for (int i = 0; i < ncounts; i++) counts[i] = default_counts[i];
+    } else {
+        if (ncounts > 64) ncounts = 64;
+        for (int i = 0; i < ncounts; i++) counts[i] = atoi(argv[optind + i]);
+    }
+
+    double *render = malloc(frames * sizeof(double));
+    double *encode = malloc(frames * sizeof(double));
+    double *transmit = malloc(frames * sizeof(double));
+    double *total = malloc(frames * sizeof(double));
+    if (!render || !encode || !transmit || !total) { perror("malloc"); return 1; }
+
+    printf("device %s, %d-bit encoding, %s kernels, %d frames per size\n",
+           device, (int)mode, ws2812_simd_name(), frames);
+
+    for (int c = 0; c < ncounts; c++) {
+        struct ws2812 dev;
+        if (counts[c] <= 0) continue;
+        if (ws2812_open(&dev, device, counts[c], mode) < 0) { perror(device); return 1; }
+
+        struct ws2812_correction corr;
+        ws2812_correction_default(&corr);
+        corr.gamma = gamma;
+        corr.brightness = 127;
+        ws2812_set_correction(&dev, &corr);
+
+        int errors = 0;
+        for (int f = 0; f < frames; f++) {
+            double t0 = now_us();
+            ws2812_hue_fill(dev.pixels, dev.led_count, (uint8_t)f, 5, 255);
+            double t1 = now_us();
+            ws2812_encode_frame(&dev);
+            double t2 = now_us();
+            if (ws2812_flush(&dev) < 0) errors++;
+            double t3 = now_us();
+
+            render[f] = t1 - t0;
+            encode[f] = t2 - t1;
+            transmit[f] = t3 - t2;
+            total[f] = t3 - t0;
+        }
+
+        // Buses run side by side: the wire time is that of the longest share
+        int buses = dev.multi != NULL ? dev.multi->count : 1;
+        size_t spi_bytes = ws2812_encoded_size(mode, dev.led_count * 3);
+        size_t bus_bytes = ws2812_encoded_size(mode, (dev.led_count + buses - 1) / buses * 3);
+        printf("%d LEDs (%zu SPI bytes/frame, %d bus%s, wire time %.0f us)\n", counts[c], spi_bytes,
+               buses, buses > 1 ? "es" : "", bus_bytes * 8 * 1e6 / ws2812_speed_hz(mode));
+        print_stage("render", render, frames);
+        print_stage("encode", encode, frames);
+        print_stage("transmit", transmit, frames);
+        print_stage("total", total, frames);
+        if (errors) printf("  %d of %d transfers failed\n", errors, frames);
+
+        ws2812_close(&dev);
+    }
+
+    free(render);
+    free(encode);
+    free(transmit);
+    free(total);
+    return 0;
+}
@@ -0,0 +1,238 @@
+// SPI benchmark: throughput, per-ioctl latency and CPU use of spidev over
+// a sweep of transfer size, speed_hz, bits_per_word and transfers per
+// SPI_IOC_MESSAGE(n), checking every byte that comes back.
+//
+// The grown-up form of SPI-TESTS/c-spi.c and newtest.c: on the board, jumper
+// MOSI to MISO and every transfer must read back what it sent. The data is
+// random, so a stuck or shorted line cannot pass by luck.
+//
+//   ./build/spi-bench [-d device] [-s sizes] [-f speeds] [-b bits] [-m xfers] [-n batches] [-x]
+//
+//   ./build/spi-bench                           # mock:, the default sweep
+//   ./build/spi-bench -d /dev/spidev0.0 -f 1M,10M,50M -s 4096
+//   ./build/spi-bench -d /dev/spidev0.0 -b 8,16,32 -m 1,8,32 -x
+//
+// Lists are comma separated; sizes are bytes per transfer, speeds take k/M.
+// -x skips the check, to see what it costs. mock: is an in-process loopback
+// with spidev's limits: it shows the program's own overhead, not the bus.
+//
+// The transfers go through a ws2812_spi batch ( ws2812_spi.h ), so a batch
+// over spidev's bufsiz is split into several messages; the msgs column
+// counts them, and latency is for the whole batch.
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/spi/spidev.h>
+#include <sys/ioctl.h>
+
+#include "ws2812_spi.h"
+
+#define MAX_LIST  16
+#define MAX_XFERS 4096
+
+static double now_sec(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+// User and system time, as precise as the scheduler keeps it
+static double cpu_sec(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// "1M,10M,500k" -> values; returns the count or -1
+static int parse_list(const char *s, long *v) {
+    int n = 0;
+    while (*s) {
+        char *end;
+        double x = strtod(s, &end);
+        if (end == s || n == MAX_LIST) return -1;
+        if (*end == 'k' || *end == 'K') { x *= 1e3; end++; }
+        else if (*end == 'M') { x *= 1e6; end++; }
+        if (x <= 0) return -1;
+        v[n++] = (long)x;
+        if (*end == ',') end++;
+        else if (*end) return -1;
+        s = end;
+    }
+    return n;
+}
+
+// spidev packs words of 9-16 bits in 2 bytes and 17-32 in 4, little
+// endian; only the low bits_per_word of each word go on the wire
+static size_t word_bytes(int bits) {
+    return bits <= 8 ? 1 : bits <= 16 ? 2 : 4;
+}
+
+static uint8_t byte_mask(int bits, size_t i) {
+    size_t w = word_bytes(bits);
+    int low = (int)(i % w) * 8;
+    int left = bits - low;
+    return left >= 8 ? 0xFF : left <= 0 ? 0 : (uint8_t)((1u << left) - 1);
+}
+
+static const char *device = "mock:";
+
+static uint64_t rng = 0x9E3779B97F4A7C15ull;
+
+static void random_fill(uint8_t *p, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        p[i] = (uint8_t)rng;
+    }
+}
+
+// Bytes of rx that differ from tx, in the bits that reach the wire
+static size_t mismatches(const uint8_t *tx, const uint8_t *rx, size_t len, int bits) {
+    if (bits == 8) {
+        if (memcmp(tx, rx, len) == 0) return 0;
+        size_t bad = 0;
+        for (size_t i = 0; i < len; i++) bad += tx[i] != rx[i];
+        return bad;
+    }
+    size_t bad = 0;
+    for (size_t i = 0; i < len; i++) {
+        uint8_t m = byte_mask(bits, i);
+        bad += (tx[i] & m) != (rx[i] & m);
+    }
+    return bad;
+}
+
+static void bench_point(struct ws2812_spi *spi, size_t size, long speed, int bits, int xfers, int messages,
+                        int verify) {
+    printf("%8zu %9ld %4d %5d  ", size, speed, bits, xfers);
+    size_t total = size * (size_t)xfers;
+
+    // Fresh random data for every batch, made ahead of the timed loop
+    const int pool = 8;
+    uint8_t *tx = malloc(total * pool);
+    uint8_t *rx = malloc(total);
+    double *latency = malloc(messages * sizeof(double));
+    struct ws2812_spi_xfer *x = calloc(xfers, sizeof(*x));
+    if (!tx || !rx || !latency || !x) {
+        printf("out of memory\n");
+        goto out;
+    }
+    random_fill(tx, total * pool);
+
+    for (int i = 0; i < xfers; i++) {
+        x[i].len = (uint32_t)size;
+        x[i].speed_hz = (uint32_t)speed;
+        x[i].bits_per_word = (uint8_t)bits;
+        x[i].rx = rx + i * size;
+    }
+
+    size_t bad = 0;
+    int failed = 0;
+    uint64_t sent = spi->messages;
+    double cpu0 = cpu_sec(), t0 = now_sec();
+    for (int m = 0; m < messages; m++) {
+        const uint8_t *data = tx + (m % pool) * total;
+        for (int i = 0; i < xfers; i++) x[i].tx = data + i * size;
+
+        double s = now_sec();
+        int ret = ws2812_spi_transfer(spi, x, (unsigned)xfers);
+        latency[m] = (now_sec() - s) * 1e6;
+        if (ret < 0) {
+            printf("failed: %s\n", strerror(errno));
+            failed = 1;
+            break;
+        }
+        if (verify) bad += mismatches(data, rx, total, bits);
+    }
+    double wall = now_sec() - t0, cpu = cpu_sec() - cpu0;
+    if (failed) goto out;
+
+    qsort(latency, messages, sizeof(double), cmp_double);
+    printf("%4.0f  %9.3f MB/s  p50 %8.1f  p99 %8.1f  max %8.1f us  cpu %5.1f%%  ",
+           (double)(spi->messages - sent) / messages, total * (double)messages / wall / 1e6,
+           latency[messages / 2], latency[(messages * 99) / 100], latency[messages - 1], 100 * cpu / wall);
+    if (!verify) printf("unchecked\n");
+    else if (bad) printf("%zu BAD BYTES\n", bad);
+    else printf("ok\n");
+
+out:
+    free(tx);
+    free(rx);
+    free(latency);
+    free(x);
+}
+
+int main(int argc, char *argv[]) {
+    long sizes[MAX_LIST] = { 16, 64, 256, 1024, 4096 }, speeds[MAX_LIST] = { 1000000, 10000000 };
+    long bits[MAX_LIST] = { 8 }, xfers[MAX_LIST] = { 1, 4, 16 };
+    int nsizes = 5, nspeeds = 2, nbits = 1, nxfers = 3;
+    int messages = 200, verify = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:s:f:b:m:n:x")) != -1) {
+        switch (opt) {
+            case 'd': device = optarg; break;
+            case 's': nsizes = parse_list(optarg, sizes); break;
+            case 'f': nspeeds = parse_list(optarg, speeds); break;
+            case 'b': nbits = parse_list(optarg, bits); break;
+            case 'm': nxfers = parse_list(optarg, xfers); break;
+            case 'n': messages = atoi(optarg); break;
+            case 'x': verify = 0; break;
+            default:
+                fprintf(stderr, "Usage: %s [-d device] [-s sizes] [-f speeds] [-b bits] [-m xfers] [-n batches] [-x]\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+    if (nsizes < 0 || nspeeds < 0 || nbits < 0 || nxfers < 0 || messages <= 0) {
+        fprintf(stderr, "Bad list or message count\n");
+        return 1;
+    }
+    for (int i = 0; i < nbits; i++) {
+        if (bits[i] > 32) { fprintf(stderr, "bits_per_word is 1-32\n"); return 1; }
+    }
+    for (int i = 0; i < nxfers; i++) {
+        if (xfers[i] > MAX_XFERS) { fprintf(stderr, "At most %d transfers a batch\n", MAX_XFERS); return 1; }
+    }
+
+    struct ws2812_spi spi;
+    if (ws2812_spi_open(&spi, device) < 0) {
+        perror(device);
+        return 1;
+    }
+    uint8_t mode = SPI_MODE_0;
+    if (spi.fd >= 0 && ioctl(spi.fd, SPI_IOC_WR_MODE, &mode) < 0) {
+        perror("Failed to set SPI mode");
+        return 1;
+    }
+
+    printf("%s, %d batches a point, bufsiz %zu%s\n", device, messages, spi.max_message,
+           spi.fd < 0 ? " (in-memory loopback)" : "");
+    printf("%8s %9s %4s %5s  %4s\n", "bytes", "speed_hz", "bits", "xfers", "msgs");
+    for (int b = 0; b < nbits; b++) {
+        for (int f = 0; f < nspeeds; f++) {
+            for (int m = 0; m < nxfers; m++) {
+                for (int s = 0; s < nsizes; s++) {
+                    // Whole words only
+                    size_t w = word_bytes((int)bits[b]);
+                    size_t size = ((size_t)sizes[s] + w - 1) / w * w;
+                    bench_point(&spi, size, speeds[f], (int)bits[b], (int)xfers[m], messages, verify);
+                }
+            }
+        }
+    }
+
+    ws2812_spi_close(&spi);
+    return 0;
+}
@@ -0,0 +1,277 @@
+#define _GNU_SOURCE     // pipe2()
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+
+#include "gpio_lines.h"
+
+static uint64_t all_lines(const struct gpio_lines *l) {
+    return l->count == 64 ? ~0ull : (1ull << l->count) - 1;
+}
+
+static int is_mock(const struct gpio_lines *l) {
+    return l->fd < 0 || l->mock_fd >= 0;
+}
+
+static int request(struct gpio_lines *l, const char *chip, const unsigned *offsets, unsigned count,
+                   enum gpio_direction direction, unsigned edges, uint64_t initial, const char *consumer) {
+    memset(l, 0, sizeof(*l));
+    l->fd = -1;
+    l->mock_fd = -1;
+    if (count == 0 || count > GPIO_MAX_LINES) {
+        errno = EINVAL;
+        return -1;
+    }
+    l->count = count;
+    l->direction = direction;
+    for (unsigned i = 0; i < count; i++) l->offsets[i] = offsets[i];
+
+    if (strcmp(chip, GPIO_MOCK_CHIP) == 0) {
+        for (unsigned i = 0; i < count; i++) {
+            if (offsets[i] >= 64) {
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        if (direction == GPIO_OUTPUT) gpio_lines_set(l, all_lines(l), initial);
+        if (edges) {
+            // Mock edges travel through a pipe, so the fd polls like a real one
+            int p[2];
+            if (pipe2(p, O_NONBLOCK | O_CLOEXEC) < 0) return -1;
+            l->fd = p[0];
+            l->mock_fd = p[1];
+        }
+        return 0;
+    }
+
+    int chip_fd = open(chip, O_RDWR | O_CLOEXEC);
+    if (chip_fd < 0) return -1;
+
+    struct gpio_v2_line_request req;
+    memset(&req, 0, sizeof(req));
+    for (unsigned i = 0; i < count; i++) req.offsets[i] = offsets[i];
+    req.num_lines = count;
+    snprintf(req.consumer, sizeof(req.consumer), "%s", consumer ? consumer : "gpio");
+
+    if (direction == GPIO_OUTPUT) {
+        req.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+        // Outputs come up at their initial level, with no glitch through 0
+        req.config.num_attrs = 1;
+        req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+        req.config.attrs[0].attr.values = initial & all_lines(l);
+        req.config.attrs[0].mask = all_lines(l);
+    } else {
+        req.config.flags = GPIO_V2_LINE_FLAG_INPUT;
+        if (edges & GPIO_EDGE_RISING) req.config.flags |= GPIO_V2_LINE_FLAG_EDGE_RISING;
+        if (edges & GPIO_EDGE_FALLING) req.config.flags |= GPIO_V2_LINE_FLAG_EDGE_FALLING;
+        // The largest queue the kernel allows, to ride out bursts between reads
+        if (edges) req.event_buffer_size = GPIO_V2_LINES_MAX * 16;
+    }
+
+    int ret = ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req);
+    int err = errno;
+    close(chip_fd);
+    if (ret < 0) {
+        errno = err;
+        return -1;
+    }
+    l->fd = req.fd;
+    if (edges) fcntl(l->fd, F_SETFL, fcntl(l->fd, F_GETFL) | O_NONBLOCK);
+    return 0;
+}
+
+int gpio_lines_request(struct gpio_lines *l, const char *chip, const unsigned *offsets, unsigned count,
+                       enum gpio_direction direction, uint64_t initial, const char *consumer) {
+    return request(l, chip, offsets, count, direction, 0, initial, consumer);
+}
+
+int gpio_lines_request_edges(struct gpio_lines *l, const char *chip, const unsigned *offsets, unsigned count,
+                             unsigned edges, const char *consumer) {
+    if ((edges & GPIO_EDGE_BOTH) == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    return request(l, chip, offsets, count, GPIO_INPUT, edges & GPIO_EDGE_BOTH, 0, consumer);
+}
+
+int gpio_lines_set(struct gpio_lines *l, uint64_t mask, uint64_t bits) {
+    mask &= all_lines(l);
+
+    if (is_mock(l)) {
+        for (unsigned i = 0; i < l->count; i++) {
+            uint64_t line = 1ull << l->offsets[i];
+            if (!(mask & (1ull << i))) continue;
+            l->mock_values = (bits >> i) & 1 ? l->mock_values | line : l->mock_values & ~line;
+        }
+        return 0;
+    }
+
+    struct gpio_v2_line_values v = { .bits = bits & mask, .mask = mask };
+    return ioctl(l->fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &v) < 0 ? -1 : 0;
+}
+
+int gpio_lines_get(struct gpio_lines *l, uint64_t mask, uint64_t *bits) {
+    mask &= all_lines(l);
+
+    if (is_mock(l)) {
+        uint64_t v = 0;
+        for (unsigned i = 0; i < l->count; i++) {
+            if ((mask & (1ull << i)) && (l->mock_values >> l->offsets[i]) & 1) v |= 1ull << i;
+        }
+        *bits = v;
+        return 0;
+    }
+
+    struct gpio_v2_line_values v = { .mask = mask };
+    if (ioctl(l->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &v) < 0) return -1;
+    *bits = v.bits & mask;
+    return 0;
+}
+
+void gpio_lines_release(struct gpio_lines *l) {
+    // Closing the request fd hands the lines back to the kernel
+    if (l->fd >= 0) close(l->fd);
+    if (l->mock_fd >= 0) close(l->mock_fd);
+    l->fd = -1;
+    l->mock_fd = -1;
+    l->count = 0;
+}
+
+static void push_event(struct gpio_event_ring *r, const struct gpio_event *ev) {
+    if (r->head - r->tail == GPIO_EVENT_RING) {
+        // Full: the oldest event goes, the consumer has fallen behind
+        r->tail++;
+        r->overruns++;
+    }
+    r->events[r->head++ % GPIO_EVENT_RING] = *ev;
+}
+
+int gpio_lines_read_events(struct gpio_lines *l, struct gpio_event_ring *r) {
+    struct gpio_v2_line_event batch[GPIO_EVENT_BATCH];
+    int total = 0;
+
+    for (;;) {
+        ssize_t n = read(l->fd, batch, sizeof(batch));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) break;
+            return -1;
+        }
+        unsigned got = (unsigned)n / sizeof(batch[0]);
+
+        for (unsigned i = 0; i < got; i++) {
+            const struct gpio_v2_line_event *k = &batch[i];
+            struct gpio_event ev = {
+                .timestamp_ns = k->timestamp_ns,
+                .lines = l,
+                .offset = k->offset,
+                .rising = k->id == GPIO_V2_LINE_EVENT_RISING_EDGE,
+            };
+            while (ev.index < l->count && l->offsets[ev.index] != k->offset) ev.index++;
+
+            // seqno counts every edge on the request, so a gap is what the
+            // kernel's queue dropped while it was full
+            if (l->seqno != 0 && k->seqno - l->seqno > 1) r->dropped += k->seqno - l->seqno - 1;
+            l->seqno = k->seqno;
+
+            push_event(r, &ev);
+        }
+        total += (int)got;
+        if (got < GPIO_EVENT_BATCH) break;
+    }
+    return total;
+}
+
+int gpio_lines_mock_edge(struct gpio_lines *l, unsigned index, int rising) {
+    if (l->mock_fd < 0 || index >= l->count) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    uint64_t line = 1ull << l->offsets[index];
+    l->mock_values = rising ? l->mock_values | line : l->mock_values & ~line;
+
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    struct gpio_v2_line_event k = {
+        .timestamp_ns = (uint64_t)t.tv_sec * 1000000000ull + (uint64_t)t.tv_nsec,
+        .id = rising ? GPIO_V2_LINE_EVENT_RISING_EDGE : GPIO_V2_LINE_EVENT_FALLING_EDGE,
+        .offset = l->offsets[index],
+        .seqno = ++l->mock_seqno,
+        .line_seqno = l->mock_seqno,
+    };
+    // A full pipe is the mock's full kernel queue: the edge is lost, and
+    // the seqno gap reports it
+    if (write(l->mock_fd, &k, sizeof(k)) < 0 && errno != EAGAIN) return -1;
+    return 0;
+}
+
+// /sys/class/gpio/gpiochipB/base holds B, and the chip's character device
+// is named in its "device/" directory as gpiochipN
+static int chip_from_sysfs(int number, char *chip, size_t chip_len, unsigned *offset) {
+    DIR *d = opendir("/sys/class/gpio");
+    if (d == NULL) return -1;
+
+    struct dirent *e;
+    int found = -1;
+    while (found < 0 && (e = readdir(d)) != NULL) {
+        if (strncmp(e->d_name, "gpiochip", 8) != 0) continue;
+
+        char path[300];
+        int base = -1, ngpio = 0;
+        snprintf(path, sizeof(path), "/sys/class/gpio/%s/base", e->d_name);
+        FILE *f = fopen(path, "r");
+        if (f == NULL) continue;
+        if (fscanf(f, "%d", &base) != 1) base = -1;
+        fclose(f);
+        snprintf(path, sizeof(path), "/sys/class/gpio/%s/ngpio", e->d_name);
+        f = fopen(path, "r");
+        if (f == NULL) continue;
+        if (fscanf(f, "%d", &ngpio) != 1) ngpio = 0;
+        fclose(f);
+        if (base < 0 || number < base || number >= base + ngpio) continue;
+
+        snprintf(path, sizeof(path), "/sys/class/gpio/%s/device", e->d_name);
+        DIR *dev = opendir(path);
+        if (dev == NULL) continue;
+        struct dirent *c;
+        while ((c = readdir(dev)) != NULL) {
+            if (strncmp(c->d_name, "gpiochip", 8) == 0) {
+                snprintf(chip, chip_len, "/dev/%s", c->d_name);
+                *offset = (unsigned)(number - base);
+                found = 0;
+                break;
+            }
+        }
+        closedir(dev);
+    }
+    closedir(d);
+    return found;
+}
+
+int gpio_line_from_number(int number, char *chip, size_t chip_len, unsigned *offset) {
+    if (number < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    const char *env = getenv("GPIO_CHIP");
+    if (env != NULL && *env != '\0') {
+        snprintf(chip, chip_len, "%s", env);
+        *offset = (unsigned)number % 32;
+        return 0;
+    }
+
+    if (chip_from_sysfs(number, chip, chip_len, offset) == 0) return 0;
+
+    snprintf(chip, chip_len, "/dev/gpiochip%d", number / 32);
+    *offset = (unsigned)number % 32;
+    return 0;
+}
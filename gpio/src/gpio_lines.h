@@ -0,0 +1,117 @@
+#ifndef GPIO_LINES_H
+#define GPIO_LINES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// GPIO lines through the character device (/dev/gpiochipN, uAPI v2).
+//
+// A set of lines on one chip is requested once; after that setting or
+// reading any of them is one ioctl on the request fd, whatever the number
+// of lines - no sysfs export, no file per pin, no formatting "1"/"0".
+//
+// Values are bitmasks: bit i is the i-th line of the request (not the line
+// offset on the chip), as in the kernel's gpio_v2_line_values.
+//
+// Inputs can also be requested with edge detection. The kernel then
+// timestamps every edge and queues it on the request fd, which can be
+// waited on with poll/epoll alongside other requests and drained in batches
+// into a gpio_event_ring: one thread watches any number of lines, sleeping
+// until something happens.
+//
+// The chip path may also be "mock:", an in-memory chip with 64 lines whose
+// inputs read back what was last driven, so programs run without hardware.
+// Its edges are injected with gpio_lines_mock_edge().
+
+#define GPIO_MAX_LINES 64          // GPIO_V2_LINES_MAX
+#define GPIO_MOCK_CHIP "mock:"
+
+enum gpio_direction {
+    GPIO_INPUT,
+    GPIO_OUTPUT,
+};
+
+// Edges to report, or'ed together
+enum gpio_edge {
+    GPIO_EDGE_RISING  = 1,
+    GPIO_EDGE_FALLING = 2,
+    GPIO_EDGE_BOTH    = 3,
+};
+
+struct gpio_lines {
+    int fd;                 // line request fd, -1 for the mock chip without edges
+    unsigned count;
+    uint32_t offsets[GPIO_MAX_LINES];
+    enum gpio_direction direction;
+    uint32_t seqno;         // last event seqno read, to spot the kernel dropping some
+
+    uint64_t mock_values;   // mock chip: current level of every line
+    int mock_fd;            // mock chip with edges: write end of the pipe fd reads
+    uint32_t mock_seqno;
+};
+
+#define GPIO_EVENT_RING  1024      // events a ring holds, a power of two
+#define GPIO_EVENT_BATCH 16        // events taken per read()
+
+struct gpio_event {
+    uint64_t timestamp_ns;          // CLOCK_MONOTONIC, taken by the kernel at the edge
+    struct gpio_lines *lines;       // request it came from
+    uint32_t offset;                // line offset on the chip
+    uint16_t index;                 // line of the request, as in the value bitmasks
+    uint8_t rising;
+};
+
+// Queue of events between the reads and whatever processes them, in one
+// thread. When it is full the oldest events are overwritten, and counted.
+struct gpio_event_ring {
+    struct gpio_event events[GPIO_EVENT_RING];
+    unsigned head, tail;            // free running; head - tail are queued
+    uint64_t overruns;              // overwritten before they were taken
+    uint64_t dropped;               // lost by the kernel, its queue was full
+};
+
+// Request count lines of chip (e.g. "/dev/gpiochip1") in one direction.
+// Outputs start at the levels in initial. consumer shows in gpioinfo.
+// Returns 0, or -1 with errno set (EBUSY if another user holds a line).
+int gpio_lines_request(struct gpio_lines *l, const char *chip, const unsigned *offsets, unsigned count,
+                       enum gpio_direction direction, uint64_t initial, const char *consumer);
+
+// Drive the lines in mask to the levels in bits, in one ioctl.
+// Returns 0, or -1 with errno set.
+int gpio_lines_set(struct gpio_lines *l, uint64_t mask, uint64_t bits);
+
+// Read the lines in mask into *bits (others read as 0), in one ioctl.
+// Returns 0, or -1 with errno set.
+int gpio_lines_get(struct gpio_lines *l, uint64_t mask, uint64_t *bits);
+
+// Request count input lines of chip, reporting the edges given (enum
+// gpio_edge). The request fd (l->fd) is non-blocking and becomes readable
+// when events are queued. Returns 0, or -1 with errno set.
+int gpio_lines_request_edges(struct gpio_lines *l, const char *chip, const unsigned *offsets, unsigned count,
+                             unsigned edges, const char *consumer);
+
+void gpio_lines_release(struct gpio_lines *l);
+
+// Move every event queued on an edge request into r, GPIO_EVENT_BATCH per
+// read(). Returns how many were moved (0 if none), or -1 with errno set.
+int gpio_lines_read_events(struct gpio_lines *l, struct gpio_event_ring *r);
+
+// Take the oldest event from r. Returns 0 if r was empty.
+static inline int gpio_event_pop(struct gpio_event_ring *r, struct gpio_event *ev) {
+    if (r->head == r->tail) return 0;
+    *ev = r->events[r->tail++ % GPIO_EVENT_RING];
+    return 1;
+}
+
+// Mock chip: line index of an edge request goes high (rising) or low and
+// the edge is queued, timestamped now. Returns 0, or -1 with errno set.
+int gpio_lines_mock_edge(struct gpio_lines *l, unsigned index, int rising);
+
+// The chip and offset of a global GPIO number (the N of sysfs gpioN).
+// Uses the chip bases sysfs publishes when it can, else 32 lines per chip
+// as on Rockchip (GPIO1_C7 = 1 * 32 + 2 * 8 + 7 = 55 -> gpiochip1 line 23).
+// With GPIO_CHIP set (e.g. GPIO_CHIP=mock:) every number maps onto that
+// chip, offset number % 32. Returns 0, or -1 with errno set.
+int gpio_line_from_number(int number, char *chip, size_t chip_len, unsigned *offset);
+
+#endif
@@ -0,0 +1,69 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "gpio_mmio.h"
+
+const uint32_t gpio_mmio_bank_base[GPIO_MMIO_BANKS] = {
+    0xFF380000,     // GPIO0
+    0xFF530000,     // GPIO1
+    0xFF540000,     // GPIO2
+    0xFF550000,     // GPIO3
+    0xFF560000,     // GPIO4
+};
+
+int gpio_mmio_open(struct gpio_mmio *m, unsigned bank, const char *path) {
+    memset(m, 0, sizeof(*m));
+    if (bank >= GPIO_MMIO_BANKS) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int fd = open(path, O_RDWR | O_SYNC | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) goto fail;
+    m->fake = S_ISREG(st.st_mode);
+
+    long page = sysconf(_SC_PAGESIZE);
+    off_t offset;
+    if (m->fake) {
+        // One page stands in for the bank
+        offset = 0;
+        if (st.st_size < page && ftruncate(fd, page) < 0) goto fail;
+    } else {
+        const char *allow = getenv("GPIO_ALLOW_DEVMEM");
+        if (allow == NULL || strcmp(allow, "1") != 0) {
+            errno = EPERM;
+            goto fail;
+        }
+        offset = gpio_mmio_bank_base[bank] & ~(uint32_t)(page - 1);
+    }
+
+    m->map_len = (size_t)page;
+    m->map = mmap(NULL, m->map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+    if (m->map == MAP_FAILED) goto fail;
+    close(fd);
+
+    size_t in_page = m->fake ? 0 : gpio_mmio_bank_base[bank] & (uint32_t)(page - 1);
+    m->regs = (volatile uint32_t *)((uint8_t *)m->map + in_page);
+    return 0;
+
+fail:;
+    int err = errno;
+    close(fd);
+    m->map = NULL;
+    errno = err;
+    return -1;
+}
+
+void gpio_mmio_close(struct gpio_mmio *m) {
+    if (m->map != NULL) munmap(m->map, m->map_len);
+    m->map = NULL;
+    m->regs = NULL;
+}
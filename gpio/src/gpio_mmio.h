@@ -0,0 +1,83 @@
+#ifndef GPIO_MMIO_H
+#define GPIO_MMIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// GPIO by writing the controller's registers from user space, through an
+// mmap of /dev/mem. No syscall per toggle: a set or clear is one store.
+//
+// This bypasses the kernel's GPIO driver entirely - nothing stops another
+// driver or process using the same pins, and a wrong address can hang the
+// board - so it is off unless GPIO_ALLOW_DEVMEM=1 is set in the environment.
+// Prefer gpio_lines.h; use this for bit-banging shift registers and strobes
+// where the ioctl per edge is the bottleneck.
+//
+// Register layout is the Rockchip GPIO v2 block of the RV1103/RV1106 (Luckfox
+// Pico boards). Its data and direction registers are split into 16-bit
+// halves whose upper 16 bits are a write enable, so setting or clearing any
+// group of pins is a single store with no read-modify-write to race with.
+//
+// The path may instead be a regular file, used as a fake register block
+// ( the benchmark's CI mode ): it is sized and mapped the same way, but the
+// stores land in the file and reads see the last word written.
+
+#define GPIO_MMIO_BANKS 5
+#define GPIO_MMIO_SIZE  0x100
+
+// Physical base of each bank on the RV1106 (TRM, "GPIO" chapter)
+extern const uint32_t gpio_mmio_bank_base[GPIO_MMIO_BANKS];
+
+// Rockchip GPIO v2 register offsets
+#define GPIO_SWPORT_DR_L   0x00     // output level, pins 0-15
+#define GPIO_SWPORT_DR_H   0x04     // output level, pins 16-31
+#define GPIO_SWPORT_DDR_L  0x08     // direction (1 = output), pins 0-15
+#define GPIO_SWPORT_DDR_H  0x0C     // direction, pins 16-31
+#define GPIO_EXT_PORT      0x70     // input levels, all 32 pins
+
+struct gpio_mmio {
+    volatile uint32_t *regs;    // the bank's registers
+    void *map;                  // page-aligned mapping regs lies in
+    size_t map_len;
+    int fake;                   // mapped a regular file, not /dev/mem
+};
+
+// Map bank (0-4) from path: "/dev/mem" (needs GPIO_ALLOW_DEVMEM=1 and root,
+// EPERM otherwise) or an existing regular file to fake the registers with.
+// Returns 0, or -1 with errno set.
+int gpio_mmio_open(struct gpio_mmio *m, unsigned bank, const char *path);
+
+void gpio_mmio_close(struct gpio_mmio *m);
+
+// Writes the pins in mask of a 16-bit half, leaving the others alone
+static inline void gpio_mmio_write_half(volatile uint32_t *reg, uint32_t mask, uint32_t bits) {
+    mask &= 0xFFFF;
+    if (mask) *reg = (mask << 16) | (bits & mask);
+}
+
+// Drive the pins in mask (bit n = pin n of the bank) to the levels in bits
+static inline void gpio_mmio_write(struct gpio_mmio *m, uint32_t mask, uint32_t bits) {
+    gpio_mmio_write_half(&m->regs[GPIO_SWPORT_DR_L / 4], mask, bits);
+    gpio_mmio_write_half(&m->regs[GPIO_SWPORT_DR_H / 4], mask >> 16, bits >> 16);
+}
+
+static inline void gpio_mmio_set(struct gpio_mmio *m, uint32_t mask) {
+    gpio_mmio_write(m, mask, mask);
+}
+
+static inline void gpio_mmio_clear(struct gpio_mmio *m, uint32_t mask) {
+    gpio_mmio_write(m, mask, 0);
+}
+
+// Make the pins in mask outputs (or inputs, with output = 0)
+static inline void gpio_mmio_direction(struct gpio_mmio *m, uint32_t mask, int output) {
+    gpio_mmio_write_half(&m->regs[GPIO_SWPORT_DDR_L / 4], mask, output ? mask : 0);
+    gpio_mmio_write_half(&m->regs[GPIO_SWPORT_DDR_H / 4], mask >> 16, output ? mask >> 16 : 0);
+}
+
+// Input levels of all 32 pins
+static inline uint32_t gpio_mmio_read(const struct gpio_mmio *m) {
+    return m->regs[GPIO_EXT_PORT / 4];
+}
+
+#endif
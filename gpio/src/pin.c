@@ -1,64 +1,282 @@
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
+#include <sys/epoll.h>
 
-int main() {
-    int gpio_pin;
-    
-    printf("Please enter the GPIO pin number: ");
-    scanf("%d", &gpio_pin);
-    
-    FILE *export_file = fopen("/sys/class/gpio/export", "w");
-    if (export_file == NULL) {
-        perror("Failed to open GPIO export file");
-        return -1;
+#include "gpio_lines.h"
+
+// Blink one or more GPIO pins three times and read each level back, or
+// watch them as inputs and count their edges.
+//
+//   ./build/pin                 asks for a pin number
+//   ./build/pin 55 56 57        several pins on one chip, toggled together
+//   ./build/pin -w 55 56 70     watch pins, on any chips, until ^C
+//   ./build/pin -w -e rising -t 10 55     count pulses for ten seconds
+//
+// Pins are the global numbers sysfs used (gpioN). Every toggle is one
+// ioctl for all the pins and every read-back another.
+//
+// Watching requests the pins of each chip as one edge-detecting input
+// request and sleeps in epoll on all of them. Whatever the kernel queued
+// is drained in batches, with its edge timestamps, into a ring; once a
+// second the edges/s of each pin and the latency from edge to read are
+// printed, with any events lost on the way.
+//
+// GPIO_CHIP=mock: runs it without the hardware; when watching, a thread
+// toggles the n-th pin every n ms.
+//
+// Build: make build/pin from the top of the repo, or gcc pin.c gpio_lines.c
+
+#define WATCH_CHIPS 8
+
+struct pin_counts {
+    uint64_t rising, falling;
+    uint64_t latency_sum_ns, latency_max_ns;
+};
+
+struct watch_chip {
+    char chip[64];
+    int pins[GPIO_MAX_LINES];
+    unsigned offsets[GPIO_MAX_LINES];
+    unsigned count;
+    struct gpio_lines lines;
+    struct pin_counts counts[GPIO_MAX_LINES];   // since the last report
+    uint64_t total[GPIO_MAX_LINES];
+};
+
+static struct watch_chip chips[WATCH_CHIPS];
+static unsigned chip_count;
+static struct gpio_event_ring ring;
+static volatile sig_atomic_t stop;
+
+static void on_signal(int sig) {
+    (void)sig;
+    stop = 1;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ull + (uint64_t)t.tv_nsec;
+}
+
+// Mock chip: the n-th line of each request flips every n ms
+static void *mock_pulses(void *arg) {
+    (void)arg;
+    for (unsigned ms = 1; !stop; ms++) {
+        for (unsigned c = 0; c < chip_count; c++) {
+            for (unsigned i = 0; i < chips[c].count; i++) {
+                if (ms % (i + 1) == 0) gpio_lines_mock_edge(&chips[c].lines, i, (ms / (i + 1)) & 1);
+            }
+        }
+        usleep(1000);
     }
-    fprintf(export_file, "%d", gpio_pin);
-    fclose(export_file);
-
-    char direction_path[50];
-    snprintf(direction_path, sizeof(direction_path), "/sys/class/gpio/gpio%d/direction", gpio_pin);
-    FILE *direction_file = fopen(direction_path, "w");
-    if (direction_file == NULL) {
-        perror("Failed to open GPIO direction file");
-        return -1;
+    return NULL;
+}
+
+static void report(double seconds, uint64_t wakeups, uint64_t events) {
+    for (unsigned c = 0; c < chip_count; c++) {
+        for (unsigned i = 0; i < chips[c].count; i++) {
+            struct pin_counts *p = &chips[c].counts[i];
+            uint64_t edges = p->rising + p->falling;
+            chips[c].total[i] += edges;
+            printf("gpio%-4d %9.0f edges/s %9.0f pulses/s  latency avg %8.1f us  max %8.1f us  (%llu total)\n",
+                   chips[c].pins[i], edges / seconds, p->rising / seconds,
+                   edges ? p->latency_sum_ns / 1e3 / edges : 0.0, p->latency_max_ns / 1e3,
+                   (unsigned long long)chips[c].total[i]);
+            memset(p, 0, sizeof(*p));
+        }
     }
-    fprintf(direction_file, "out");
-    fclose(direction_file);
-
-    char value_path[50];
-    char cat_command[100];
-    snprintf(value_path, sizeof(value_path), "/sys/class/gpio/gpio%d/value", gpio_pin);
-    snprintf(cat_command, sizeof(cat_command), "cat %s", value_path);
-    FILE *value_file = fopen(value_path, "w");
-    if (value_file == NULL) {
-        perror("Failed to open GPIO value file");
+    printf("%llu wakeups, %.1f events each, %llu lost in the kernel, %llu overrun\n\n",
+           (unsigned long long)wakeups, wakeups ? (double)events / wakeups : 0.0,
+           (unsigned long long)ring.dropped, (unsigned long long)ring.overruns);
+    fflush(stdout);
+}
+
+static int watch(const int *pins, unsigned count, unsigned edges, double duration) {
+    // One request per chip, every pin of that chip in it
+    for (unsigned i = 0; i < count; i++) {
+        char chip[64];
+        unsigned offset, c;
+        if (gpio_line_from_number(pins[i], chip, sizeof(chip), &offset) < 0) {
+            perror("Bad GPIO pin number");
+            return -1;
+        }
+        for (c = 0; c < chip_count && strcmp(chips[c].chip, chip) != 0; c++) {}
+        if (c == chip_count) {
+            if (chip_count == WATCH_CHIPS) {
+                fprintf(stderr, "More than %d GPIO chips\n", WATCH_CHIPS);
+                return -1;
+            }
+            snprintf(chips[chip_count++].chip, sizeof(chip), "%s", chip);
+        }
+        if (chips[c].count == GPIO_MAX_LINES) {
+            fprintf(stderr, "More than %d pins on %s\n", GPIO_MAX_LINES, chip);
+            return -1;
+        }
+        chips[c].pins[chips[c].count] = pins[i];
+        chips[c].offsets[chips[c].count++] = offset;
+    }
+
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    if (ep < 0) {
+        perror("epoll_create1");
         return -1;
-    }   
+    }
+    int mock = 0;
+    for (unsigned c = 0; c < chip_count; c++) {
+        struct watch_chip *w = &chips[c];
+        if (gpio_lines_request_edges(&w->lines, w->chip, w->offsets, w->count, edges, "pin") < 0) {
+            fprintf(stderr, "Failed to request GPIO lines on %s: %s\n", w->chip, strerror(errno));
+            return -1;
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = w };
+        if (epoll_ctl(ep, EPOLL_CTL_ADD, w->lines.fd, &ev) < 0) {
+            perror("epoll_ctl");
+            return -1;
+        }
+        mock |= strcmp(w->chip, GPIO_MOCK_CHIP) == 0;
+    }
 
-    for (int i = 0; i < 3; i++) {
-        fprintf(value_file, "1");
-        fflush(value_file);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    pthread_t pulses;
+    if (mock) pthread_create(&pulses, NULL, mock_pulses, NULL);
 
-        system(cat_command);
-        sleep(1);
+    uint64_t start = now_ns(), last = start, wakeups = 0, events = 0;
+    while (!stop) {
+        uint64_t now = now_ns();
+        if (now - last >= 1000000000ull) {
+            report((now - last) / 1e9, wakeups, events);
+            last = now;
+            wakeups = events = 0;
+        }
+        if (duration > 0 && now - start >= duration * 1e9) break;
 
-        fprintf(value_file, "0");
-        fflush(value_file);
-        
-        system(cat_command);
-        sleep(1);
+        struct epoll_event ready[WATCH_CHIPS];
+        int timeout_ms = (int)((last + 1000000000ull - now) / 1000000) + 1;
+        int n = epoll_wait(ep, ready, WATCH_CHIPS, timeout_ms);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+        if (n == 0) continue;
+        wakeups++;
+
+        for (int r = 0; r < n; r++) {
+            struct watch_chip *w = ready[r].data.ptr;
+            int got = gpio_lines_read_events(&w->lines, &ring);
+            if (got < 0) perror("GPIO event read failed");
+            else events += (uint64_t)got;
+        }
+
+        // Latency is edge to the end of the batch read that picked it up
+        uint64_t read_at = now_ns();
+        struct gpio_event ev;
+        while (gpio_event_pop(&ring, &ev)) {
+            unsigned c = 0;
+            while (c < chip_count && &chips[c].lines != ev.lines) c++;
+            if (c == chip_count || ev.index >= chips[c].count) continue;
+            struct pin_counts *p = &chips[c].counts[ev.index];
+            if (ev.rising) p->rising++;
+            else p->falling++;
+            uint64_t latency = read_at > ev.timestamp_ns ? read_at - ev.timestamp_ns : 0;
+            p->latency_sum_ns += latency;
+            if (latency > p->latency_max_ns) p->latency_max_ns = latency;
+        }
     }
 
-    fclose(value_file);
+    stop = 1;
+    if (mock) pthread_join(pulses, NULL);
+    for (unsigned c = 0; c < chip_count; c++) gpio_lines_release(&chips[c].lines);
+    close(ep);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int pins[GPIO_MAX_LINES];
+    unsigned count = 0;
+    int watching = 0;
+    unsigned edges = GPIO_EDGE_BOTH;
+    double duration = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "we:t:")) != -1) {
+        switch (opt) {
+            case 'w': watching = 1; break;
+            case 'e':
+                if (strcmp(optarg, "rising") == 0) edges = GPIO_EDGE_RISING;
+                else if (strcmp(optarg, "falling") == 0) edges = GPIO_EDGE_FALLING;
+                else if (strcmp(optarg, "both") == 0) edges = GPIO_EDGE_BOTH;
+                else { fprintf(stderr, "Edges are rising, falling or both\n"); return -1; }
+                break;
+            case 't': duration = atof(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [pin...]\n       %s -w [-e rising|falling|both] [-t seconds] pin...\n",
+                        argv[0], argv[0]);
+                return -1;
+        }
+    }
 
-    FILE *unexport_file = fopen("/sys/class/gpio/unexport", "w");
-    if (unexport_file == NULL) {
-        perror("Failed to open GPIO unexport file");
+    if (optind < argc) {
+        for (int i = optind; i < argc && count < GPIO_MAX_LINES; i++) pins[count++] = atoi(argv[i]);
+    } else if (watching) {
+        fprintf(stderr, "Which pins to watch?\n");
         return -1;
+    } else {
+        printf("Please enter the GPIO pin number: ");
+        if (scanf("%d", &pins[0]) != 1) {
+            fprintf(stderr, "Not a pin number\n");
+            return -1;
+        }
+        count = 1;
+    }
+
+    if (watching) return watch(pins, count, edges, duration) < 0 ? -1 : 0;
+
+    // All pins go in one line request, so they must share a chip
+    char chip[64], other[64];
+    unsigned offsets[GPIO_MAX_LINES];
+    for (unsigned i = 0; i < count; i++) {
+        if (gpio_line_from_number(pins[i], i ? other : chip, sizeof(chip), &offsets[i]) < 0) {
+            perror("Bad GPIO pin number");
+            return -1;
+        }
+        if (i && strcmp(chip, other) != 0) {
+            fprintf(stderr, "GPIO %d is on %s, not %s with GPIO %d\n", pins[i], other, chip, pins[0]);
+            return -1;
+        }
+    }
+
+    struct gpio_lines lines;
+    if (gpio_lines_request(&lines, chip, offsets, count, GPIO_OUTPUT, 0, "pin") < 0) {
+        perror("Failed to request GPIO lines");
+        return -1;
+    }
+
+    uint64_t all = count == 64 ? ~0ull : (1ull << count) - 1;
+    for (int i = 0; i < 6; i++) {
+        // High, low, high, ...
+        uint64_t level = i % 2 == 0 ? all : 0, read_back;
+        if (gpio_lines_set(&lines, all, level) < 0 || gpio_lines_get(&lines, all, &read_back) < 0) {
+            perror("GPIO ioctl failed");
+            break;
+        }
+        for (unsigned p = 0; p < count; p++) {
+            printf("%s%llu", p ? " " : "", (unsigned long long)((read_back >> p) & 1));
+        }
+        printf("\n");
+        fflush(stdout);
+        sleep(1);
     }
-    fprintf(unexport_file, "%d", gpio_pin);
-    fclose(unexport_file);
 
+    // Releasing the request gives the lines back, as unexport did
+    gpio_lines_release(&lines);
     return 0;
 }
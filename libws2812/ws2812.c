@@ -0,0 +1,286 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "ws2812.h"
+#include "ws2812_multi.h"
+#include "ws2812_shm.h"
+
+// LEDs compared per step when looking for changed ranges
+#define WS2812_DIRTY_CHUNK_LEDS 16
+
+static void free_buf(uint8_t **buf, size_t *cap) {
+    if (*buf != NULL) {
+        munlock(*buf, *cap);
+        munmap(*buf, *cap);
+    }
+    *buf = NULL;
+    *cap = 0;
+}
+
+// Make sure *buf holds at least 'need' bytes, keeping its contents. Anonymous
+// mmap gives page aligned, zeroed memory; mlock keeps it resident so a frame
+// never page faults.
+static int reserve_buf(uint8_t **buf, size_t *cap, size_t need) {
+    if (need <= *cap) return 0;
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t new_cap = (need + page - 1) / page * page;
+
+    uint8_t *p = mmap(NULL, new_cap, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return -1;
+
+    // Not fatal: unprivileged users may hit RLIMIT_MEMLOCK
+    mlock(p, new_cap);
+
+    if (*buf != NULL) memcpy(p, *buf, *cap);
+    free_buf(buf, cap);
+    *buf = p;
+    *cap = new_cap;
+    return 0;
+}
+
+static int open_shm(struct ws2812 *dev, const char *name, size_t led_count) {
+    dev->shm = malloc(sizeof(*dev->shm));
+    if (dev->shm == NULL) return -1;
+
+    if (ws2812_shm_attach(dev->shm, name) < 0) goto fail;
+    if (led_count > dev->shm->hdr->led_count) {
+        ws2812_shm_close(dev->shm);
+        errno = EINVAL;
+        goto fail;
+    }
+    return 0;
+
+fail:;
+    int err = errno;
+    free(dev->shm);
+    dev->shm = NULL;
+    errno = err;
+    return -1;
+}
+
+int ws2812_open(struct ws2812 *dev, const char *path, size_t led_count, enum ws2812_mode mode) {
+    memset(dev, 0, sizeof(*dev));
+    dev->mode = mode;
+    dev->keepalive_ms = WS2812_DEFAULT_KEEPALIVE_MS;
+
+    if (strncmp(path, "shm:", 4) == 0) {
+        if (open_shm(dev, path[4] ? path + 4 : WS2812_SHM_DEFAULT, led_count) < 0) return -1;
+    } else if (strchr(path, ',') != NULL) {
+        dev->multi = ws2812_multi_open(path, led_count, mode);
+        if (dev->multi == NULL) return -1;
+    } else if (ws2812_transport_open(&dev->transport, path, mode) < 0) {
+        return -1;
+    }
+
+    if (ws2812_resize(dev, led_count) < 0) {
+        int err = errno;
+        ws2812_close(dev);
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+int ws2812_resize(struct ws2812 *dev, size_t led_count) {
+    if (reserve_buf(&dev->pixels, &dev->pixels_cap, led_count * 3) < 0) return -1;
+    // The outputs (or the daemon) hold the encode buffers
+    if (dev->shm != NULL) {
+        if (led_count > dev->shm->hdr->led_count) {
+            errno = EINVAL;
+            return -1;
+        }
+    } else if (dev->multi != NULL) {
+        if (ws2812_multi_resize(dev->multi, led_count) < 0) return -1;
+    } else {
+        if (reserve_buf(&dev->spi_buf, &dev->spi_cap, ws2812_encoded_size(dev->mode, led_count * 3)) < 0) return -1;
+        if (reserve_buf(&dev->shadow, &dev->shadow_cap, led_count * 3) < 0) return -1;
+        if (reserve_buf(&dev->corrected, &dev->corrected_cap, led_count * 3) < 0) return -1;
+    }
+    dev->shadow_valid = 0;
+
+    // Shrinking then growing again must not bring back stale colors
+    if (led_count < dev->led_count) {
+        memset(dev->pixels + led_count * 3, 0, (dev->led_count - led_count) * 3);
+    }
+    dev->led_count = led_count;
+    return 0;
+}
+
+void ws2812_close(struct ws2812 *dev) {
+    if (dev->multi != NULL) ws2812_multi_close(dev->multi);
+    dev->multi = NULL;
+    if (dev->shm != NULL) {
+        ws2812_shm_close(dev->shm);
+        free(dev->shm);
+    }
+    dev->shm = NULL;
+    ws2812_stats_close(dev->stats);
+    dev->stats = NULL;
+    free_buf(&dev->spi_buf, &dev->spi_cap);
+    free_buf(&dev->pixels, &dev->pixels_cap);
+    free_buf(&dev->shadow, &dev->shadow_cap);
+    free_buf(&dev->corrected, &dev->corrected_cap);
+    ws2812_transport_close(&dev->transport);
+}
+
+void ws2812_fill(struct ws2812 *dev, uint8_t r, uint8_t g, uint8_t b) {
+    for (size_t i = 0; i < dev->led_count; i++) {
+        ws2812_set_pixel(dev, i, r, g, b);
+    }
+}
+
+void ws2812_clear(struct ws2812 *dev) {
+    memset(dev->pixels, 0, dev->led_count * 3);
+}
+
+void ws2812_set_frame_rgb(struct ws2812 *dev, const uint8_t *rgb) {
+    ws2812_rgb_to_grb(dev->pixels, rgb, dev->led_count);
+}
+
+static void encode_range(struct ws2812 *dev, const uint8_t *grb, size_t start, size_t end) {
+    const uint8_t *src = grb + start;
+
+    if (dev->lut_enabled) {
+        ws2812_lut_apply(&dev->lut, dev->corrected + start, src, (end - start) / 3);
+        src = dev->corrected + start;
+    }
+    ws2812_encode_mode(dev->mode, dev->spi_buf + ws2812_encoded_size(dev->mode, start),
+                       src, end - start);
+
+    // The shadow holds uncorrected pixels: that is what the next frame is compared to
+    memcpy(dev->shadow + start, grb + start, end - start);
+}
+
+static size_t encode_frame(struct ws2812 *dev, const uint8_t *grb) {
+    size_t len = dev->led_count * 3;
+
+    if (dev->multi != NULL) return ws2812_multi_encode(dev->multi, grb);
+    if (dev->shm != NULL) {
+        // The daemon does the encoding (and skips unchanged frames): just
+        // make sure the frame is in the shared buffer
+        uint8_t *back = ws2812_shm_begin(dev->shm);
+        if (back != grb) memcpy(back, grb, len);
+        return len;
+    }
+
+    if (!dev->shadow_valid) {
+        encode_range(dev, grb, 0, len);
+        dev->shadow_valid = 1;
+        return len;
+    }
+
+    // Walk the frame in chunks and re-encode each run of changed chunks
+    // in one call. Chunks are whole LEDs, so encoded offsets stay byte aligned
+    // in every mode.
+    const size_t chunk = WS2812_DIRTY_CHUNK_LEDS * 3;
+    size_t changed = 0;
+    size_t run_start = 0;
+    int in_run = 0;
+
+    for (size_t pos = 0; pos < len; pos += chunk) {
+        size_t n = len - pos < chunk ? len - pos : chunk;
+        int dirty = memcmp(grb + pos, dev->shadow + pos, n) != 0;
+
+        if (dirty && !in_run) {
+            run_start = pos;
+            in_run = 1;
+        } else if (!dirty && in_run) {
+            encode_range(dev, grb, run_start, pos);
+            changed += pos - run_start;
+            in_run = 0;
+        }
+    }
+    if (in_run) {
+        encode_range(dev, grb, run_start, len);
+        changed += len - run_start;
+    }
+    return changed;
+}
+
+size_t ws2812_encode_frame_from(struct ws2812 *dev, const uint8_t *grb) {
+    if (dev->stats == NULL) return encode_frame(dev, grb);
+
+    uint64_t start = ws2812_stats_now();
+    size_t changed = encode_frame(dev, grb);
+    ws2812_stats_record(dev->stats, WS2812_STAGE_ENCODE, ws2812_stats_now() - start);
+    return changed;
+}
+
+size_t ws2812_encode_frame(struct ws2812 *dev) {
+    return ws2812_encode_frame_from(dev, dev->pixels);
+}
+
+int ws2812_should_flush(struct ws2812 *dev, size_t changed) {
+    if (changed > 0 || dev->keepalive_ms == 0) return 1;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long idle_ms = (long long)(now.tv_sec - dev->last_flush.tv_sec) * 1000 +
+                        (now.tv_nsec - dev->last_flush.tv_nsec) / 1000000;
+    return idle_ms >= dev->keepalive_ms;
+}
+
+void ws2812_set_keepalive(struct ws2812 *dev, long ms) {
+    dev->keepalive_ms = ms;
+}
+
+void ws2812_set_correction(struct ws2812 *dev, const struct ws2812_correction *c) {
+    if (dev->multi != NULL) ws2812_multi_set_correction(dev->multi, c);
+    if (dev->shm != NULL) ws2812_shm_set_correction(dev->shm, c);
+
+    if (c == NULL) {
+        if (dev->lut_enabled) dev->shadow_valid = 0;
+        dev->lut_enabled = 0;
+        return;
+    }
+    if (ws2812_lut_update(&dev->lut, c) || !dev->lut_enabled) {
+        dev->shadow_valid = 0;
+    }
+    dev->lut_enabled = 1;
+}
+
+int ws2812_flush(struct ws2812 *dev) {
+    size_t len = ws2812_encoded_size(dev->mode, dev->led_count * 3);
+    uint64_t start = dev->stats ? ws2812_stats_now() : 0;
+    int ret;
+
+    if (dev->shm != NULL) {
+        ws2812_shm_publish(dev->shm);
+        ret = 0;
+    } else if (dev->multi != NULL) {
+        ret = ws2812_multi_flush(dev->multi);
+    } else {
+        ret = ws2812_transport_send(&dev->transport, dev->spi_buf, len);
+    }
+
+    if (dev->stats != NULL) {
+        ws2812_stats_record(dev->stats, WS2812_STAGE_SEND, ws2812_stats_now() - start);
+        if (ret < 0) {
+            atomic_fetch_add_explicit(&dev->stats->errors, 1, memory_order_relaxed);
+            atomic_store_explicit(&dev->stats->last_error, errno, memory_order_relaxed);
+        }
+    }
+
+    if (ret < 0) {
+        // The LEDs may not show this frame: send it again next time
+        memset(&dev->last_flush, 0, sizeof(dev->last_flush));
+        return -1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &dev->last_flush);
+    return 0;
+}
+
+int ws2812_show(struct ws2812 *dev) {
+    size_t changed = ws2812_encode_frame(dev);
+
+    if (!ws2812_should_flush(dev, changed)) {
+        dev->frames_skipped++;
+        if (dev->stats != NULL) atomic_fetch_add_explicit(&dev->stats->skipped, 1, memory_order_relaxed);
+        return 0;
+    }
+    return ws2812_flush(dev);
+}
@@ -0,0 +1,132 @@
+#ifndef WS2812_H
+#define WS2812_H
+
+// libws2812 - WS2812B LED chains driven from a spidev MOSI pin.
+//
+//   struct ws2812 dev;
+//   ws2812_open(&dev, "/dev/spidev0.0", 64, ws2812_mode_from_env());
+//   ws2812_set_pixel(&dev, 0, 255, 0, 0);
+//   ws2812_show(&dev);          // ws2812_encode_frame() + ws2812_flush()
+//   ws2812_close(&dev);
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "ws2812_clock.h"
+#include "ws2812_color.h"
+#include "ws2812_correct.h"
+#include "ws2812_encode.h"
+#include "ws2812_frame.h"
+#include "ws2812_layout.h"
+#include "ws2812_map.h"
+#include "ws2812_stats.h"
+#include "ws2812_transport.h"
+
+struct ws2812_multi;
+struct ws2812_shm;
+
+// One WS2812 chain on one spidev node (or a mock, see ws2812_transport.h).
+// The pixel and encode buffers are sized once in ws2812_open() and only grow
+// when the LED count does, so showing a frame never touches the heap.
+struct ws2812 {
+    struct ws2812_transport transport;
+    enum ws2812_mode mode;
+    size_t led_count;
+
+    uint8_t *pixels;    // led_count * 3 bytes, WS2812 G-R-B order
+    size_t pixels_cap;
+
+    uint8_t *spi_buf;   // encoded frame: page aligned, mlock'ed
+    size_t spi_cap;     // bytes mapped at spi_buf (whole pages)
+
+    // Dirty tracking: the GRB bytes spi_buf currently encodes
+    uint8_t *shadow;
+    size_t shadow_cap;
+    int shadow_valid;
+
+    // Correction stage between pixels and encoder (see ws2812_set_correction)
+    struct ws2812_lut lut;
+    int lut_enabled;
+    uint8_t *corrected;         // scratch for corrected bytes before encoding
+    size_t corrected_cap;
+
+    long keepalive_ms;          // resend an unchanged frame this often, 0 = always send
+    struct timespec last_flush;
+    uint64_t frames_skipped;    // unchanged frames not sent
+
+    // Set when the chain is split over several buses (see ws2812_multi.h):
+    // encoding and sending are then done by the outputs' own threads
+    struct ws2812_multi *multi;
+
+    // Set for "shm:" paths: frames go to the LED daemon's shared framebuffer
+    // (see ws2812_shm.h), which encodes and sends them
+    struct ws2812_shm *shm;
+
+    // Stage timings and send errors go here when set (see ws2812_stats.h)
+    struct ws2812_stats *stats;
+};
+
+// Unchanged frames are resent after this long in case a panel lost power
+#define WS2812_DEFAULT_KEEPALIVE_MS 1000
+
+// Open the SPI device (or mock: / file: / unix: backend) and size the
+// buffers for led_count LEDs (all off). A comma separated list of paths
+// splits the LEDs evenly across several buses driven in parallel, and
+// "shm:/name" draws through a running ws2812d.
+// Returns 0, or -1 with errno set.
+int ws2812_open(struct ws2812 *dev, const char *path, size_t led_count, enum ws2812_mode mode);
+
+// Change the LED count. Reuses the existing buffers when they are big enough;
+// pixels that exist in both sizes keep their color.
+int ws2812_resize(struct ws2812 *dev, size_t led_count);
+
+void ws2812_close(struct ws2812 *dev);
+
+// --- Pixels ---
+// Colors are given as R, G, B and stored in the chain's G-R-B order.
+// Out of range indexes are ignored.
+static inline void ws2812_set_pixel(struct ws2812 *dev, size_t i, uint8_t r, uint8_t g, uint8_t b) {
+    if (i >= dev->led_count) return;
+    dev->pixels[i * 3]     = g;
+    dev->pixels[i * 3 + 1] = r;
+    dev->pixels[i * 3 + 2] = b;
+}
+
+void ws2812_fill(struct ws2812 *dev, uint8_t r, uint8_t g, uint8_t b);
+void ws2812_clear(struct ws2812 *dev);
+
+// Load a whole frame of led_count R-G-B pixels (whole-frame swizzle kernel).
+void ws2812_set_frame_rgb(struct ws2812 *dev, const uint8_t *rgb);
+
+// --- Output ---
+// Encode the pixel buffer into the SPI buffer. Only LED ranges that differ
+// from the last encoded frame are re-encoded. Returns the number of GRB bytes
+// in the ranges that changed, 0 if the frame is identical.
+size_t ws2812_encode_frame(struct ws2812 *dev);
+
+// Same, from a GRB buffer of led_count * 3 bytes other than dev->pixels.
+size_t ws2812_encode_frame_from(struct ws2812 *dev, const uint8_t *grb);
+
+// Whether a frame with 'changed' dirty bytes needs sending: always when it
+// changed, otherwise only once the keepalive interval has run out.
+int ws2812_should_flush(struct ws2812 *dev, size_t changed);
+
+// Send the last encoded frame in one transfer followed by the latch delay.
+// Returns 0, or -1 with errno set if the transfer failed.
+int ws2812_flush(struct ws2812 *dev);
+
+// ws2812_encode_frame() then ws2812_flush(), skipping the transfer when
+// ws2812_should_flush() says the LEDs already show this frame.
+int ws2812_show(struct ws2812 *dev);
+
+// 0 turns skipping off: every frame is sent.
+void ws2812_set_keepalive(struct ws2812 *dev, long ms);
+
+// Apply gamma / white point / brightness to every frame before encoding.
+// The tables are rebuilt (and the next frame fully re-encoded) only when c
+// differs from the last call. NULL turns correction off. Not thread safe
+// against a running pipeline writer: set it before ws2812_pipeline_start().
+void ws2812_set_correction(struct ws2812 *dev, const struct ws2812_correction *c);
+
+#endif
@@ -0,0 +1,106 @@
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "ws2812_clock.h"
+#include "ws2812_stats.h"
+
+#define NSEC_PER_SEC 1000000000LL
+
+// Nanosecond counts are int64_t throughout: long is 32 bits on the board,
+// where 2.1 s of nanoseconds already overflows it
+static void timespec_add_ns(struct timespec *t, int64_t ns) {
+    int64_t nsec = t->tv_nsec + ns % NSEC_PER_SEC;
+    t->tv_sec += (time_t)(ns / NSEC_PER_SEC);
+    if (nsec >= NSEC_PER_SEC) {
+        nsec -= NSEC_PER_SEC;
+        t->tv_sec++;
+    } else if (nsec < 0) {
+        nsec += NSEC_PER_SEC;
+        t->tv_sec--;
+    }
+    t->tv_nsec = (long)nsec;
+}
+
+static int64_t timespec_diff_ns(const struct timespec *a, const struct timespec *b) {
+    return (int64_t)(a->tv_sec - b->tv_sec) * NSEC_PER_SEC + (a->tv_nsec - b->tv_nsec);
+}
+
+void ws2812_clock_init(struct ws2812_clock *clk, long period_us) {
+    memset(clk, 0, sizeof(*clk));
+    // Missed deadlines are counted in periods: never let one be 0
+    if (period_us < 1) period_us = 1;
+    clk->period_ns = (int64_t)period_us * 1000;
+    clock_gettime(CLOCK_MONOTONIC, &clk->next);
+    clk->last_log = clk->next;
+    timespec_add_ns(&clk->next, clk->period_ns);
+}
+
+static void log_misses(struct ws2812_clock *clk, const struct timespec *now) {
+    if (clk->missed == clk->missed_logged) return;
+    if (timespec_diff_ns(now, &clk->last_log) < NSEC_PER_SEC) return;
+
+    fprintf(stderr, "frame clock: missed %llu deadline(s) in the last second (worst %.1f ms late, %llu/%llu total)\n",
+            (unsigned long long)(clk->missed - clk->missed_logged), clk->worst_late_ns / 1e6,
+            (unsigned long long)clk->missed, (unsigned long long)clk->frames);
+    clk->missed_logged = clk->missed;
+    clk->last_log = *now;
+}
+
+int ws2812_clock_wait(struct ws2812_clock *clk) {
+    struct timespec now;
+    int missed = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    clk->frames++;
+
+    int64_t late = timespec_diff_ns(&now, &clk->next);
+    if (late >= 0) {
+        // Already past the deadline: skip every period that has gone by
+        // and start the next frame straight away
+        if (late > clk->worst_late_ns) clk->worst_late_ns = late;
+        missed = (int)(late / clk->period_ns) + 1;
+        clk->missed += missed;
+        if (clk->stats != NULL) {
+            atomic_fetch_add_explicit(&clk->stats->missed, missed, memory_order_relaxed);
+            ws2812_stats_record(clk->stats, WS2812_STAGE_WAKE, (uint64_t)late);
+        }
+        timespec_add_ns(&clk->next, clk->period_ns * (int64_t)missed);
+        log_misses(clk, &now);
+        return missed;
+    }
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &clk->next, NULL) == EINTR) {
+    }
+    if (clk->stats != NULL) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        ws2812_stats_record(clk->stats, WS2812_STAGE_WAKE, (uint64_t)timespec_diff_ns(&now, &clk->next));
+    }
+    timespec_add_ns(&clk->next, clk->period_ns);
+    return 0;
+}
+
+int ws2812_sched_fifo(int priority) {
+    struct sched_param sp = { .sched_priority = priority };
+
+    if (sched_setscheduler(0, SCHED_FIFO, &sp) < 0) return -1;
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) < 0) return -1;
+    return 0;
+}
+
+void ws2812_sched_fifo_from_env(void) {
+    const char *s = getenv("WS2812_FIFO_PRIO");
+    if (s == NULL) return;
+
+    int priority = atoi(s);
+    if (priority < 1 || priority > 99) {
+        fprintf(stderr, "Ignoring WS2812_FIFO_PRIO=%s (use 1-99)\n", s);
+        return;
+    }
+    if (ws2812_sched_fifo(priority) < 0) {
+        perror("Can't switch to SCHED_FIFO");
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef WS2812_CLOCK_H
+#define WS2812_CLOCK_H
+
+#include <stdint.h>
+#include <time.h>
+
+struct ws2812_stats;
+
+// Fixed-rate frame clock.
+// Deadlines are absolute CLOCK_MONOTONIC times (start + n * period), so time
+// spent rendering and in the SPI ioctl does not push later frames back the way
+// a usleep() after each frame does.
+struct ws2812_clock {
+    struct timespec next;   // deadline of the next frame
+    int64_t period_ns;
+
+    uint64_t frames;        // deadlines waited for
+    uint64_t missed;        // deadlines already past when we got there
+    int64_t worst_late_ns;  // latest we have ever been for a deadline
+
+    // Missed deadlines are logged to stderr at most once per second
+    uint64_t missed_logged;
+    struct timespec last_log;
+
+    // Wake-up lateness and missed deadlines are also counted here if set
+    // (e.g. clk.stats = dev.stats, see ws2812_stats.h)
+    struct ws2812_stats *stats;
+};
+
+// Periods under 1 us are taken as 1 us
+void ws2812_clock_init(struct ws2812_clock *clk, long period_us);
+
+// Sleep until the next deadline. If one or more deadlines have already passed
+// they are skipped (no burst of catch-up frames) and counted as missed.
+// Returns the number of deadlines missed by this call, normally 0.
+int ws2812_clock_wait(struct ws2812_clock *clk);
+
+// Run the calling process under SCHED_FIFO at the given priority (1-99) and
+// lock all its memory. Returns 0, or -1 with errno set (usually EPERM).
+int ws2812_sched_fifo(int priority);
+
+// ws2812_sched_fifo() with the priority from WS2812_FIFO_PRIO, if set.
+// Failures are reported on stderr and otherwise ignored.
+void ws2812_sched_fifo_from_env(void);
+
+#endif
@@ -0,0 +1,115 @@
+#include <string.h>
+
+#include "ws2812_color.h"
+#include "ws2812_encode.h"
+
+#if WS2812_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+// --- Hue wheel table ---
+// Same math as ws2812_hsv_to_rgb(), evaluated by the preprocessor:
+// six 43-step regions, each ramping one channel up or down.
+#define REGION(h) ((h) / 43)
+#define T(h) ((((h) - REGION(h) * 43) * 6) & 0xFF)
+#define Q(h) (255 - T(h))
+#define RED(h)   (REGION(h) == 0 ? 255 : REGION(h) == 1 ? Q(h) : REGION(h) <= 3 ? 0 : REGION(h) == 4 ? T(h) : 255)
+#define GREEN(h) (REGION(h) == 0 ? T(h) : REGION(h) <= 2 ? 255 : REGION(h) == 3 ? Q(h) : 0)
+#define BLUE(h)  (REGION(h) <= 1 ? 0 : REGION(h) == 2 ? T(h) : REGION(h) <= 4 ? 255 : Q(h))
+#define ROW(h) { GREEN(h), RED(h), BLUE(h) }
+#define R4(h) ROW(h), ROW((h) + 1), ROW((h) + 2), ROW((h) + 3)
+#define R16(h) R4(h), R4((h) + 4), R4((h) + 8), R4((h) + 12)
+#define R64(h) R16(h), R16((h) + 16), R16((h) + 32), R16((h) + 48)
+
+const uint8_t ws2812_hue_grb[256][3] = { R64(0), R64(64), R64(128), R64(192) };
+
+#undef REGION
+#undef T
+#undef Q
+#undef RED
+#undef GREEN
+#undef BLUE
+#undef ROW
+#undef R4
+#undef R16
+#undef R64
+
+void ws2812_hsv_to_rgb(uint8_t h, float brightness, uint8_t *r, uint8_t *g, uint8_t *b) {
+    uint8_t region = h / 43;
+    uint8_t remainder = (h - (region * 43)) * 6;
+    uint8_t q = 255 - remainder;
+    uint8_t t = remainder;
+    uint8_t raw_r, raw_g, raw_b;
+
+    switch (region) {
+        case 0:  raw_r = 255; raw_g = t;   raw_b = 0;   break;
+        case 1:  raw_r = q;   raw_g = 255; raw_b = 0;   break;
+        case 2:  raw_r = 0;   raw_g = 255; raw_b = t;   break;
+        case 3:  raw_r = 0;   raw_g = q;   raw_b = 255; break;
+        case 4:  raw_r = t;   raw_g = 0;   raw_b = 255; break;
+        default: raw_r = 255; raw_g = 0;   raw_b = q;   break;
+    }
+
+    *r = (uint8_t)(raw_r * brightness);
+    *g = (uint8_t)(raw_g * brightness);
+    *b = (uint8_t)(raw_b * brightness);
+}
+
+uint8_t ws2812_brightness_level(float brightness) {
+    // level + 1 = brightness * 256, so 0.5 -> 127 scales 255 to 127 like the float path
+    float level = brightness * 256.0f - 1.0f;
+    if (level <= 0.0f) return 0;
+    if (level >= 255.0f) return 255;
+    return (uint8_t)(level + 0.5f);
+}
+
+void ws2812_hue_fill(uint8_t *grb, size_t count, uint8_t hue, uint8_t hue_step, uint8_t level) {
+    unsigned scale = level + 1u;
+
+    for (size_t i = 0; i < count; i++, hue += hue_step) {
+        const uint8_t *c = ws2812_hue_grb[hue];
+        grb[i * 3]     = (uint8_t)((c[0] * scale) >> 8);
+        grb[i * 3 + 1] = (uint8_t)((c[1] * scale) >> 8);
+        grb[i * 3 + 2] = (uint8_t)((c[2] * scale) >> 8);
+    }
+}
+
+void ws2812_crossfade_scalar(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t len, unsigned w) {
+    unsigned wa = 256 - w;
+
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = (uint8_t)((a[i] * wa + b[i] * w) >> 8);
+    }
+}
+
+#if WS2812_HAVE_NEON
+// Inside the ends both weights fit a byte: two widening multiplies into
+// 16 bits ( at most 255 * 256 ) and a narrowing shift
+void ws2812_crossfade(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t len, unsigned w) {
+    if (w == 0 || w >= 256) {
+        memmove(dst, w ? b : a, len);
+        return;
+    }
+
+    const uint8x8_t wa = vdup_n_u8((uint8_t)(256 - w));
+    const uint8x8_t wb = vdup_n_u8((uint8_t)w);
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t va = vld1q_u8(a + i);
+        uint8x16_t vb = vld1q_u8(b + i);
+        uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(va), wa), vget_low_u8(vb), wb);
+        uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(va), wa), vget_high_u8(vb), wb);
+        vst1q_u8(dst + i, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+    }
+    ws2812_crossfade_scalar(dst + i, a + i, b + i, len - i, w);
+}
+#else
+void ws2812_crossfade(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t len, unsigned w) {
+    if (w == 0 || w >= 256) {
+        memmove(dst, w ? b : a, len);
+        return;
+    }
+    ws2812_crossfade_scalar(dst, a, b, len, w);
+}
+#endif
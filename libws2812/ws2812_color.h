@@ -0,0 +1,44 @@
+#ifndef WS2812_COLOR_H
+#define WS2812_COLOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Hue is 0-255 at full saturation. Each channel is scaled by brightness
+// (0.0 to 1.0); pass 1.0 for the raw wheel color.
+// Float reference for the fixed-point kernel below.
+void ws2812_hsv_to_rgb(uint8_t h, float brightness, uint8_t *r, uint8_t *g, uint8_t *b);
+
+// --- Fixed-point color kernel ---
+// Brightness is a uint8 level: a channel is scaled by (level + 1) / 256 with
+// one multiply and a shift, so 255 leaves it untouched and 0 turns it off.
+// Hues come from a 256-entry table holding the same wheel as ws2812_hsv_to_rgb(),
+// already in WS2812 G-R-B order. No divides, no branches, no floats.
+
+extern const uint8_t ws2812_hue_grb[256][3];
+
+static inline uint8_t ws2812_scale8(uint8_t v, uint8_t level) {
+    return (uint8_t)((v * (level + 1)) >> 8);
+}
+
+// Float brightness (0.0 to 1.0) -> level, matching the truncation of the float path
+uint8_t ws2812_brightness_level(float brightness);
+
+static inline void ws2812_hue_to_rgb(uint8_t h, uint8_t level, uint8_t *r, uint8_t *g, uint8_t *b) {
+    *g = ws2812_scale8(ws2812_hue_grb[h][0], level);
+    *r = ws2812_scale8(ws2812_hue_grb[h][1], level);
+    *b = ws2812_scale8(ws2812_hue_grb[h][2], level);
+}
+
+// Write count GRB pixels whose hues run hue, hue + hue_step, ... (wrapping)
+// at the given level. A whole rainbow row or frame in one call.
+void ws2812_hue_fill(uint8_t *grb, size_t count, uint8_t hue, uint8_t hue_step, uint8_t level);
+
+// dst = (a * (256 - w) + b * w) >> 8 over len channel bytes, w 0..256, so
+// both ends are exact copies. dst may be a or b. NEON does 16 bytes a step.
+void ws2812_crossfade(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t len, unsigned w);
+
+// The plain C version, whatever the build. Reference for the NEON path.
+void ws2812_crossfade_scalar(uint8_t *dst, const uint8_t *a, const uint8_t *b, size_t len, unsigned w);
+
+#endif
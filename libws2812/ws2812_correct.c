@@ -0,0 +1,66 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ws2812_correct.h"
+#include "ws2812_frame.h"
+
+void ws2812_correction_default(struct ws2812_correction *c) {
+    c->gamma = 1.0f;
+    c->white[0] = c->white[1] = c->white[2] = 255;
+    c->brightness = 255;
+}
+
+void ws2812_correction_from_env(struct ws2812_correction *c) {
+    const char *s = getenv("WS2812_GAMMA");
+    if (s != NULL) {
+        float gamma = atof(s);
+        if (gamma >= 0.1f && gamma <= 5.0f) {
+            c->gamma = gamma;
+        } else {
+            fprintf(stderr, "Ignoring WS2812_GAMMA=%s (use 0.1 to 5.0)\n", s);
+        }
+    }
+
+    s = getenv("WS2812_WHITE");
+    if (s != NULL) {
+        unsigned r, g, b;
+        if (sscanf(s, "%u,%u,%u", &r, &g, &b) == 3 && r <= 255 && g <= 255 && b <= 255) {
+            c->white[0] = r;
+            c->white[1] = g;
+            c->white[2] = b;
+        } else {
+            fprintf(stderr, "Ignoring WS2812_WHITE=%s (use R,G,B each 0-255)\n", s);
+        }
+    }
+}
+
+static int same_params(const struct ws2812_correction *a, const struct ws2812_correction *b) {
+    return a->gamma == b->gamma && a->brightness == b->brightness &&
+           a->white[0] == b->white[0] && a->white[1] == b->white[1] && a->white[2] == b->white[2];
+}
+
+int ws2812_lut_update(struct ws2812_lut *lut, const struct ws2812_correction *c) {
+    if (lut->valid && same_params(&lut->params, c)) return 0;
+
+    // G-R-B table order, white point given as R-G-B
+    static const int white_index[3] = { 1, 0, 2 };
+    // 0 must be off: the tables round, and (0 + 1) / 256 of 255 rounds to 1
+    double level = c->brightness / 255.0;
+
+    for (int ch = 0; ch < 3; ch++) {
+        double max = c->white[white_index[ch]] * level;
+        for (int v = 0; v < 256; v++) {
+            double out = pow(v / 255.0, c->gamma) * max;
+            lut->grb[ch][v] = (uint8_t)(out + 0.5);
+        }
+    }
+
+    lut->params = *c;
+    lut->valid = 1;
+    return 1;
+}
+
+void ws2812_lut_apply(const struct ws2812_lut *lut, uint8_t *dst, const uint8_t *src, size_t count) {
+    ws2812_lut3_frame(dst, src, count, lut->grb);
+}
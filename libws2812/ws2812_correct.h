@@ -0,0 +1,37 @@
+#ifndef WS2812_CORRECT_H
+#define WS2812_CORRECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Color correction applied to every pixel just before encoding.
+// Gamma, white point and global brightness are folded into one 256-entry
+// table per channel, so the frame path costs a lookup per byte and the float
+// math only runs when a parameter changes.
+struct ws2812_correction {
+    float gamma;            // 1.0 = linear; 2.2 - 2.8 looks even on WS2812B
+    uint8_t white[3];       // R, G, B maximum (255, 255, 255 = no correction)
+    uint8_t brightness;     // 0 = off, 255 = full ( ws2812_brightness_level() )
+};
+
+struct ws2812_lut {
+    uint8_t grb[3][256];    // tables in WS2812 G-R-B order
+    struct ws2812_correction params;    // what the tables were built from
+    int valid;
+};
+
+// Linear, no white point correction, full brightness
+void ws2812_correction_default(struct ws2812_correction *c);
+
+// Override c from WS2812_GAMMA ("2.2") and WS2812_WHITE ("255,200,180").
+// Bad values are reported on stderr and ignored.
+void ws2812_correction_from_env(struct ws2812_correction *c);
+
+// Build the tables for c. Does nothing if they already match c.
+// Returns 1 if the tables changed, 0 if not.
+int ws2812_lut_update(struct ws2812_lut *lut, const struct ws2812_correction *c);
+
+// Correct count G-R-B pixels from src into dst (may be the same buffer).
+void ws2812_lut_apply(const struct ws2812_lut *lut, uint8_t *dst, const uint8_t *src, size_t count);
+
+#endif
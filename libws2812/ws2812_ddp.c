@@ -0,0 +1,123 @@
+#define _GNU_SOURCE     // recvmmsg()
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "ws2812_ddp.h"
+#include "ws2812_frame.h"
+
+struct ws2812_ddp_batch {
+    struct mmsghdr msgs[WS2812_DDP_BATCH];
+    struct iovec iov[WS2812_DDP_BATCH];
+    uint8_t pkt[WS2812_DDP_BATCH][WS2812_DDP_HEADER_LEN + 4 + WS2812_DDP_MAX_DATA];
+};
+
+int ws2812_ddp_open(struct ws2812_ddp *ddp, int port) {
+    memset(ddp, 0, sizeof(*ddp));
+    ddp->fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (ddp->fd < 0) return -1;
+
+    // Room for a few frames of a big wall while the daemon is busy
+    int rcvbuf = 4 << 20;
+    setsockopt(ddp->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port ? port : WS2812_DDP_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    ddp->batch = calloc(1, sizeof(*ddp->batch));
+    if (ddp->batch == NULL || bind(ddp->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        int err = errno;
+        ws2812_ddp_close(ddp);
+        errno = err;
+        return -1;
+    }
+
+    struct ws2812_ddp_batch *b = ddp->batch;
+    for (int i = 0; i < WS2812_DDP_BATCH; i++) {
+        b->iov[i].iov_base = b->pkt[i];
+        b->iov[i].iov_len = sizeof(b->pkt[i]);
+        b->msgs[i].msg_hdr.msg_iov = &b->iov[i];
+        b->msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    return 0;
+}
+
+int ws2812_ddp_receive(struct ws2812_ddp *ddp, int timeout_ms) {
+    struct pollfd pfd = { .fd = ddp->fd, .events = POLLIN };
+
+    int ready = poll(&pfd, 1, timeout_ms);
+    if (ready <= 0) return (ready < 0 && errno != EINTR) ? -1 : 0;
+
+    int n = recvmmsg(ddp->fd, ddp->batch->msgs, WS2812_DDP_BATCH, MSG_DONTWAIT, NULL);
+    if (n < 0) return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+
+    ddp->stats.packets += n;
+    ddp->stats.batches++;
+    return n;
+}
+
+static uint32_t be32(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+int ws2812_ddp_apply(struct ws2812_ddp *ddp, int i, uint8_t *grb, size_t led_count) {
+    const uint8_t *pkt = ddp->batch->pkt[i];
+    size_t got = ddp->batch->msgs[i].msg_len;
+
+    size_t header = WS2812_DDP_HEADER_LEN + ((pkt[0] & WS2812_DDP_FLAG_TIME) ? 4 : 0);
+    if (got < header || (pkt[0] & 0xC0) != WS2812_DDP_FLAG_VER1) goto bad;
+
+    // Only pixel data: no queries, replies or stored configuration, and the
+    // data type RGB at 8 bits a channel (many senders leave it undefined)
+    if (pkt[0] & (WS2812_DDP_FLAG_STORAGE | WS2812_DDP_FLAG_REPLY | WS2812_DDP_FLAG_QUERY)) goto bad;
+    if (pkt[2] != WS2812_DDP_TYPE_RGB8 && pkt[2] != 0) goto bad;
+
+    uint32_t offset = be32(pkt + 4);
+    size_t len = (size_t)pkt[8] << 8 | pkt[9];
+    // Whole pixels only, inside the frame: the swizzle works per pixel.
+    // Compared without adding, so a huge offset cannot wrap a 32-bit size_t
+    size_t cap = led_count * 3;
+    if (len > got - header || offset % 3 != 0 || len % 3 != 0 || offset > cap || len > cap - offset) goto bad;
+
+    // R-G-B off the wire into the chain's G-R-B: the one pass the bytes need anyway
+    ws2812_rgb_to_grb(grb + offset, pkt + header, len / 3);
+    ddp->stats.bytes += len;
+
+    if (pkt[0] & WS2812_DDP_FLAG_PUSH) {
+        ddp->stats.frames++;
+        return 1;
+    }
+    return 0;
+
+bad:
+    ddp->stats.bad++;
+    return -1;
+}
+
+void ws2812_ddp_close(struct ws2812_ddp *ddp) {
+    if (ddp->fd >= 0) close(ddp->fd);
+    free(ddp->batch);
+    ddp->fd = -1;
+    ddp->batch = NULL;
+}
+
+size_t ws2812_ddp_pack(uint8_t *pkt, uint8_t seq, uint32_t offset, const uint8_t *rgb, size_t len, int push) {
+    pkt[0] = WS2812_DDP_FLAG_VER1 | (push ? WS2812_DDP_FLAG_PUSH : 0);
+    pkt[1] = seq & 0x0F;
+    pkt[2] = WS2812_DDP_TYPE_RGB8;
+    pkt[3] = 1;         // default output device
+    pkt[4] = offset >> 24;
+    pkt[5] = offset >> 16;
+    pkt[6] = offset >> 8;
+    pkt[7] = offset;
+    pkt[8] = len >> 8;
+    pkt[9] = len;
+    if (len > 0) memcpy(pkt + WS2812_DDP_HEADER_LEN, rgb, len);
+    return WS2812_DDP_HEADER_LEN + len;
+}
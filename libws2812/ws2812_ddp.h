@@ -0,0 +1,71 @@
+#ifndef WS2812_DDP_H
+#define WS2812_DDP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// DDP (Distributed Display Protocol) over UDP, as spoken by xLights, WLED
+// and most show controllers. Each packet carries a run of R-G-B bytes at a
+// byte offset into the frame; a packet with the PUSH flag (with or without
+// data) presents the frame.
+//
+//   byte 0     flags: 0x40 version 1, 0x10 timecode follows, 0x08 storage,
+//              0x04 reply, 0x02 query, 0x01 push
+//   byte 1     sequence (low 4 bits)
+//   byte 2     data type: 0x0B is RGB, 8 bits a channel (0 = undefined)
+//   byte 3     destination id
+//   bytes 4-7  data offset in bytes, big endian
+//   bytes 8-9  data length in bytes, big endian
+//   (bytes 10-13 timecode, when flagged)
+#define WS2812_DDP_PORT 4048
+#define WS2812_DDP_HEADER_LEN 10
+#define WS2812_DDP_FLAG_VER1 0x40
+#define WS2812_DDP_FLAG_TIME 0x10
+#define WS2812_DDP_FLAG_STORAGE 0x08
+#define WS2812_DDP_FLAG_REPLY 0x04
+#define WS2812_DDP_FLAG_QUERY 0x02
+#define WS2812_DDP_FLAG_PUSH 0x01
+#define WS2812_DDP_TYPE_RGB8 0x0B
+#define WS2812_DDP_MAX_DATA 1440        // 480 pixels: fits a 1500 byte MTU
+
+// Packets taken per recvmmsg() call
+#define WS2812_DDP_BATCH 32
+
+struct ws2812_ddp_stats {
+    uint64_t packets;       // packets received
+    uint64_t bytes;         // pixel bytes written into frames
+    uint64_t frames;        // pushes
+    uint64_t bad;           // packets dropped as malformed or out of range
+    uint64_t batches;       // recvmmsg() calls that returned packets
+};
+
+struct ws2812_ddp_batch;
+
+struct ws2812_ddp {
+    int fd;
+    struct ws2812_ddp_batch *batch;     // recvmmsg() headers and packet buffers
+    struct ws2812_ddp_stats stats;
+};
+
+// Bind a UDP socket on port (0 = WS2812_DDP_PORT), all addresses.
+// Returns 0, or -1 with errno set.
+int ws2812_ddp_open(struct ws2812_ddp *ddp, int port);
+
+// Wait up to timeout_ms (-1 = forever) for packets and take up to
+// WS2812_DDP_BATCH of them in one call. Returns how many, 0 on timeout or
+// signal, -1 with errno set on error.
+int ws2812_ddp_receive(struct ws2812_ddp *ddp, int timeout_ms);
+
+// Write packet i of the last batch into a G-R-B frame of led_count LEDs.
+// Queries, replies, storage packets and data other than 8-bit RGB are
+// dropped, as is anything that would land outside the frame.
+// Returns 1 if it presents the frame (PUSH), 0 if not, -1 if it was dropped.
+int ws2812_ddp_apply(struct ws2812_ddp *ddp, int i, uint8_t *grb, size_t led_count);
+
+void ws2812_ddp_close(struct ws2812_ddp *ddp);
+
+// Build a packet in pkt (room for WS2812_DDP_HEADER_LEN + len bytes) carrying
+// len R-G-B bytes at byte offset 'offset'. Returns the packet length.
+size_t ws2812_ddp_pack(uint8_t *pkt, uint8_t seq, uint32_t offset, const uint8_t *rgb, size_t len, int push);
+
+#endif
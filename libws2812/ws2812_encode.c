@@ -0,0 +1,203 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ws2812_encode.h"
+
+#if WS2812_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+// --- Byte -> 8 SPI byte expansion table ---
+// Built by the preprocessor so there is no init step and no ordering issue
+// between threads. Stored as bytes, so the layout is the same on any endianness.
+#define E(b, n) (((b) >> (n)) & 1 ? WS2812_1 : WS2812_0)
+#define ROW(b) { E(b, 7), E(b, 6), E(b, 5), E(b, 4), E(b, 3), E(b, 2), E(b, 1), E(b, 0) }
+#define R4(b) ROW(b), ROW((b) + 1), ROW((b) + 2), ROW((b) + 3)
+#define R16(b) R4(b), R4((b) + 4), R4((b) + 8), R4((b) + 12)
+#define R64(b) R16(b), R16((b) + 16), R16((b) + 32), R16((b) + 48)
+
+static const uint8_t ws2812_lut[256][WS2812_SPI_BYTES_PER_BYTE]
+    __attribute__((aligned(8))) = { R64(0), R64(64), R64(128), R64(192) };
+
+#undef ROW
+
+// --- Compact modes ---
+// 3-bit symbols: '0' = 100 (4), '1' = 110 (6). 8 symbols pack into 24 bits.
+// 4-bit symbols: '0' = 1000 (0x8), '1' = 1110 (0xE). 8 symbols pack into 32 bits.
+#define S3(b, n) ((uint32_t)(((b) >> (n)) & 1 ? 6 : 4) << (3 * (n)))
+#define P3(b) (S3(b, 7) | S3(b, 6) | S3(b, 5) | S3(b, 4) | S3(b, 3) | S3(b, 2) | S3(b, 1) | S3(b, 0))
+#define S4(b, n) ((uint32_t)(((b) >> (n)) & 1 ? 0xE : 0x8) << (4 * (n)))
+#define P4(b) (S4(b, 7) | S4(b, 6) | S4(b, 5) | S4(b, 4) | S4(b, 3) | S4(b, 2) | S4(b, 1) | S4(b, 0))
+
+#define ROW(b) { (uint8_t)(P3(b) >> 16), (uint8_t)(P3(b) >> 8), (uint8_t)P3(b) }
+static const uint8_t ws2812_lut3[256][3] = { R64(0), R64(64), R64(128), R64(192) };
+#undef ROW
+
+#define ROW(b) { (uint8_t)(P4(b) >> 24), (uint8_t)(P4(b) >> 16), (uint8_t)(P4(b) >> 8), (uint8_t)P4(b) }
+static const uint8_t ws2812_lut4[256][4] __attribute__((aligned(4))) = { R64(0), R64(64), R64(128), R64(192) };
+#undef ROW
+
+#undef E
+#undef R4
+#undef R16
+#undef R64
+#undef S3
+#undef P3
+#undef S4
+#undef P4
+
+void ws2812_encode_scalar(uint8_t *dst, const uint8_t *src, size_t len) {
+    // memcpy of a fixed 8 bytes compiles to one 64-bit load/store pair
+    for (size_t i = 0; i < len; i++) {
+        memcpy(dst + i * WS2812_SPI_BYTES_PER_BYTE, ws2812_lut[src[i]], WS2812_SPI_BYTES_PER_BYTE);
+    }
+}
+
+#if WS2812_HAVE_NEON
+// Two input bytes per step: broadcast each across 8 lanes, test one bit per
+// lane (MSB first) and select 0xFC or 0xC0. 16 SPI bytes per store.
+#define EXPAND_PAIR(v, lo, hi, out)                                              \
+    do {                                                                         \
+        uint8x16_t bytes = vcombine_u8(vdup_lane_u8(v, lo), vdup_lane_u8(v, hi)); \
+        uint8x16_t ones = vtstq_u8(bytes, bit_mask);                             \
+        vst1q_u8(out, vbslq_u8(ones, sym_1, sym_0));                             \
+    } while (0)
+
+void ws2812_encode(uint8_t *dst, const uint8_t *src, size_t len) {
+    static const uint8_t bits[16] = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                      0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+    const uint8x16_t bit_mask = vld1q_u8(bits);
+    const uint8x16_t sym_0 = vdupq_n_u8(WS2812_0);
+    const uint8x16_t sym_1 = vdupq_n_u8(WS2812_1);
+    size_t i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        uint8x8_t v = vld1_u8(src + i);
+        uint8_t *out = dst + i * WS2812_SPI_BYTES_PER_BYTE;
+        EXPAND_PAIR(v, 0, 1, out);
+        EXPAND_PAIR(v, 2, 3, out + 16);
+        EXPAND_PAIR(v, 4, 5, out + 32);
+        EXPAND_PAIR(v, 6, 7, out + 48);
+    }
+    ws2812_encode_scalar(dst + i * WS2812_SPI_BYTES_PER_BYTE, src + i, len - i);
+}
+
+#undef EXPAND_PAIR
+#else
+void ws2812_encode(uint8_t *dst, const uint8_t *src, size_t len) {
+    ws2812_encode_scalar(dst, src, len);
+}
+#endif
+
+void ws2812_encode_ref(uint8_t *dst, const uint8_t *src, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        for (int bit = 7; bit >= 0; bit--) {
+            dst[i * 8 + (7 - bit)] = (src[i] & (1 << bit)) ? WS2812_1 : WS2812_0;
+        }
+    }
+}
+
+size_t ws2812_encoded_size(enum ws2812_mode mode, size_t len) {
+    return len * (size_t)mode;
+}
+
+uint32_t ws2812_speed_hz(enum ws2812_mode mode) {
+    // One WS2812 bit period is 1.25us, split into 'mode' SPI bits
+    return (uint32_t)mode * 800000;
+}
+
+void ws2812_encode_mode(enum ws2812_mode mode, uint8_t *dst, const uint8_t *src, size_t len) {
+    switch (mode) {
+        case WS2812_MODE_4BIT:
+            for (size_t i = 0; i < len; i++) {
+                memcpy(dst + i * 4, ws2812_lut4[src[i]], 4);
+            }
+            break;
+        case WS2812_MODE_3BIT:
+            for (size_t i = 0; i < len; i++) {
+                memcpy(dst + i * 3, ws2812_lut3[src[i]], 3);
+            }
+            break;
+        default:
+            ws2812_encode(dst, src, len);
+            break;
+    }
+}
+
+long ws2812_decode(enum ws2812_mode mode, uint8_t *dst, const uint8_t *src, size_t spi_len) {
+    unsigned width = (unsigned)mode;
+    uint8_t sym_0, sym_1;
+
+    switch (mode) {
+        case WS2812_MODE_4BIT: sym_0 = 0x8; sym_1 = 0xE; break;
+        case WS2812_MODE_3BIT: sym_0 = 0x4; sym_1 = 0x6; break;
+        default:               sym_0 = WS2812_0; sym_1 = WS2812_1; break;
+    }
+
+    // 8-bit symbols are whole bytes: no bit reader needed
+    if (mode == WS2812_MODE_8BIT) {
+        size_t out_len = spi_len / 8;
+        for (size_t i = 0; i < out_len; i++) {
+            uint8_t byte = 0;
+            for (int bit = 0; bit < 8; bit++) {
+                uint8_t sym = src[i * 8 + bit];
+                if (sym != WS2812_0 && sym != WS2812_1) return -1;
+                byte = (uint8_t)((byte << 1) | (sym == WS2812_1));
+            }
+            dst[i] = byte;
+        }
+        return (long)out_len;
+    }
+
+    // Read the stream MSB first, one symbol of 'width' bits per data bit
+    size_t total_bits = spi_len * 8;
+    size_t out_len = total_bits / (width * 8);
+    size_t pos = 0;
+
+    for (size_t i = 0; i < out_len; i++) {
+        uint8_t byte = 0;
+        for (int bit = 0; bit < 8; bit++) {
+            uint8_t sym = 0;
+            for (unsigned k = 0; k < width; k++, pos++) {
+                sym = (uint8_t)((sym << 1) | ((src[pos / 8] >> (7 - pos % 8)) & 1));
+            }
+            if (sym == sym_1) {
+                byte = (uint8_t)((byte << 1) | 1);
+            } else if (sym == sym_0) {
+                byte = (uint8_t)(byte << 1);
+            } else {
+                return -1;
+            }
+        }
+        dst[i] = byte;
+    }
+    return (long)out_len;
+}
+
+int ws2812_parse_mode(const char *s, enum ws2812_mode *mode) {
+    char *end;
+
+    // The whole string is the number: no sign, spaces or trailing junk
+    if (s == NULL || !isdigit((unsigned char)s[0])) return -1;
+    long n = strtol(s, &end, 10);
+    if (*end != '\0') return -1;
+    switch (n) {
+        case 8: *mode = WS2812_MODE_8BIT; return 0;
+        case 4: *mode = WS2812_MODE_4BIT; return 0;
+        case 3: *mode = WS2812_MODE_3BIT; return 0;
+        default: return -1;
+    }
+}
+
+enum ws2812_mode ws2812_mode_from_env(void) {
+    enum ws2812_mode mode = WS2812_MODE_8BIT;
+    const char *s = getenv("WS2812_MODE");
+
+    if (s != NULL && ws2812_parse_mode(s, &mode) < 0) {
+        fprintf(stderr, "Ignoring WS2812_MODE=%s (use 8, 4 or 3)\n", s);
+        mode = WS2812_MODE_8BIT;
+    }
+    return mode;
+}
@@ -0,0 +1,70 @@
+#ifndef WS2812_ENCODE_H
+#define WS2812_ENCODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// WS2812B "Bit" encoding via SPI bytes
+// At ~6.4MHz, 0xC0 (~25% duty) is '0' and 0xFC (~75% duty) is '1'
+#define WS2812_0 0xC0
+#define WS2812_1 0xFC
+
+// One GRB channel byte becomes 8 SPI bytes (one per data bit, MSB first)
+#define WS2812_SPI_BYTES_PER_BYTE 8
+
+// Latch time (Reset pulse) after each frame
+#define WS2812_LATCH_USECS 50
+
+// NEON kernels are used when the compiler targets NEON (make NEON=1 on the
+// Pico) unless WS2812_NO_NEON is defined. Otherwise the portable scalar code
+// is built, which is what runs on x86.
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(WS2812_NO_NEON)
+#define WS2812_HAVE_NEON 1
+#else
+#define WS2812_HAVE_NEON 0
+#endif
+
+// How many SPI bits are spent on each WS2812 data bit.
+// The compact modes run the SPI clock slower so one period is still ~1.25us:
+//   WS2812_MODE_8BIT  6.4MHz  '0' = 11000000  '1' = 11111100  (24 bytes/LED)
+//   WS2812_MODE_4BIT  3.2MHz  '0' = 1000      '1' = 1110      (12 bytes/LED)
+//   WS2812_MODE_3BIT  2.4MHz  '0' = 100       '1' = 110       ( 9 bytes/LED)
+enum ws2812_mode {
+    WS2812_MODE_8BIT = 8,
+    WS2812_MODE_4BIT = 4,
+    WS2812_MODE_3BIT = 3,
+};
+
+// Expand len channel bytes from src into len * 8 SPI bytes at dst.
+// Uses a 256-entry table so every input byte is a single 64-bit copy, or
+// NEON compare/select over 8 bytes at a time when WS2812_HAVE_NEON.
+void ws2812_encode(uint8_t *dst, const uint8_t *src, size_t len);
+
+// The table version, whatever the build. Reference for the NEON path.
+void ws2812_encode_scalar(uint8_t *dst, const uint8_t *src, size_t len);
+
+// The original per-bit loop. Kept as the reference the table is checked against.
+void ws2812_encode_ref(uint8_t *dst, const uint8_t *src, size_t len);
+
+// SPI bytes needed for len channel bytes, and the clock the mode expects.
+size_t ws2812_encoded_size(enum ws2812_mode mode, size_t len);
+uint32_t ws2812_speed_hz(enum ws2812_mode mode);
+
+// Encode len channel bytes in the given mode. dst must hold
+// ws2812_encoded_size(mode, len) bytes.
+void ws2812_encode_mode(enum ws2812_mode mode, uint8_t *dst, const uint8_t *src, size_t len);
+
+// Turn an SPI stream back into channel bytes, so a waveform can be checked
+// without a scope. Returns the number of bytes decoded, or -1 if a symbol is
+// neither a valid '0' nor '1'.
+long ws2812_decode(enum ws2812_mode mode, uint8_t *dst, const uint8_t *src, size_t spi_len);
+
+// "8", "4" or "3" -> mode. Returns 0 on success, -1 if the string is anything
+// else ( "4x", " 3" and "" included ).
+int ws2812_parse_mode(const char *s, enum ws2812_mode *mode);
+
+// Mode from the WS2812_MODE environment variable (e.g. Environment= in a
+// systemd unit). Falls back to WS2812_MODE_8BIT when unset or invalid.
+enum ws2812_mode ws2812_mode_from_env(void);
+
+#endif
@@ -0,0 +1,153 @@
+#include "ws2812_color.h"
+#include "ws2812_frame.h"
+
+#if WS2812_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+// --- Scalar kernels ---
+
+void ws2812_rgb_to_grb_scalar(uint8_t *dst, const uint8_t *src, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint8_t r = src[i * 3];
+        uint8_t g = src[i * 3 + 1];
+        uint8_t b = src[i * 3 + 2];
+        dst[i * 3]     = g;
+        dst[i * 3 + 1] = r;
+        dst[i * 3 + 2] = b;
+    }
+}
+
+void ws2812_scale_frame_scalar(uint8_t *buf, size_t len, uint8_t level) {
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = ws2812_scale8(buf[i], level);
+    }
+}
+
+void ws2812_lut_frame_scalar(uint8_t *buf, size_t len, const uint8_t lut[256]) {
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = lut[buf[i]];
+    }
+}
+
+void ws2812_lut3_frame_scalar(uint8_t *dst, const uint8_t *src, size_t count, const uint8_t lut[3][256]) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i * 3]     = lut[0][src[i * 3]];
+        dst[i * 3 + 1] = lut[1][src[i * 3 + 1]];
+        dst[i * 3 + 2] = lut[2][src[i * 3 + 2]];
+    }
+}
+
+#if WS2812_HAVE_NEON
+// --- NEON kernels: 16 bytes (or 16 pixels) per step, scalar tail ---
+
+const char *ws2812_simd_name(void) {
+    return "neon";
+}
+
+void ws2812_rgb_to_grb(uint8_t *dst, const uint8_t *src, size_t count) {
+    size_t i = 0;
+
+    // vld3 de-interleaves into R, G and B planes; store them back G, R, B
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x3_t px = vld3q_u8(src + i * 3);
+        uint8x16_t r = px.val[0];
+        px.val[0] = px.val[1];
+        px.val[1] = r;
+        vst3q_u8(dst + i * 3, px);
+    }
+    ws2812_rgb_to_grb_scalar(dst + i * 3, src + i * 3, count - i);
+}
+
+void ws2812_scale_frame(uint8_t *buf, size_t len, uint8_t level) {
+    const uint8x8_t lv = vdup_n_u8(level);
+    size_t i = 0;
+
+    // v * (level + 1) >> 8, computed as (v * level + v) >> 8 in 16 bits
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8(buf + i);
+        uint16x8_t lo = vaddw_u8(vmull_u8(vget_low_u8(v), lv), vget_low_u8(v));
+        uint16x8_t hi = vaddw_u8(vmull_u8(vget_high_u8(v), lv), vget_high_u8(v));
+        vst1q_u8(buf + i, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+    }
+    ws2812_scale_frame_scalar(buf + i, len - i, level);
+}
+
+// vtbl4 looks up 32 entries at a time and returns 0 for indexes past the
+// end, so a 256-entry table is eight lookups OR'ed together, each on the
+// index shifted down by 32 (indexes below the window wrap high and miss).
+static inline uint8x8_t lut_lookup8(uint8x8_t idx, const uint8x8x4_t tbl[8]) {
+    const uint8x8_t step = vdup_n_u8(32);
+    uint8x8_t out = vtbl4_u8(tbl[0], idx);
+
+    for (int k = 1; k < 8; k++) {
+        idx = vsub_u8(idx, step);
+        out = vorr_u8(out, vtbl4_u8(tbl[k], idx));
+    }
+    return out;
+}
+
+static void load_lut(uint8x8x4_t tbl[8], const uint8_t lut[256]) {
+    for (int k = 0; k < 8; k++) {
+        tbl[k].val[0] = vld1_u8(lut + k * 32);
+        tbl[k].val[1] = vld1_u8(lut + k * 32 + 8);
+        tbl[k].val[2] = vld1_u8(lut + k * 32 + 16);
+        tbl[k].val[3] = vld1_u8(lut + k * 32 + 24);
+    }
+}
+
+static inline uint8x16_t lut_lookup16(uint8x16_t v, const uint8x8x4_t tbl[8]) {
+    return vcombine_u8(lut_lookup8(vget_low_u8(v), tbl), lut_lookup8(vget_high_u8(v), tbl));
+}
+
+void ws2812_lut_frame(uint8_t *buf, size_t len, const uint8_t lut[256]) {
+    uint8x8x4_t tbl[8];
+    size_t i = 0;
+
+    load_lut(tbl, lut);
+    for (; i + 16 <= len; i += 16) {
+        vst1q_u8(buf + i, lut_lookup16(vld1q_u8(buf + i), tbl));
+    }
+    ws2812_lut_frame_scalar(buf + i, len - i, lut);
+}
+
+void ws2812_lut3_frame(uint8_t *dst, const uint8_t *src, size_t count, const uint8_t lut[3][256]) {
+    uint8x8x4_t tbl[3][8];
+    size_t i = 0;
+
+    for (int c = 0; c < 3; c++) load_lut(tbl[c], lut[c]);
+
+    // De-interleave 16 pixels into channel planes, one table per plane
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x3_t px = vld3q_u8(src + i * 3);
+        px.val[0] = lut_lookup16(px.val[0], tbl[0]);
+        px.val[1] = lut_lookup16(px.val[1], tbl[1]);
+        px.val[2] = lut_lookup16(px.val[2], tbl[2]);
+        vst3q_u8(dst + i * 3, px);
+    }
+    ws2812_lut3_frame_scalar(dst + i * 3, src + i * 3, count - i, lut);
+}
+
+#else
+// --- Portable build ---
+
+const char *ws2812_simd_name(void) {
+    return "scalar";
+}
+
+void ws2812_rgb_to_grb(uint8_t *dst, const uint8_t *src, size_t count) {
+    ws2812_rgb_to_grb_scalar(dst, src, count);
+}
+
+void ws2812_scale_frame(uint8_t *buf, size_t len, uint8_t level) {
+    ws2812_scale_frame_scalar(buf, len, level);
+}
+
+void ws2812_lut_frame(uint8_t *buf, size_t len, const uint8_t lut[256]) {
+    ws2812_lut_frame_scalar(buf, len, lut);
+}
+
+void ws2812_lut3_frame(uint8_t *dst, const uint8_t *src, size_t count, const uint8_t lut[3][256]) {
+    ws2812_lut3_frame_scalar(dst, src, count, lut);
+}
+#endif
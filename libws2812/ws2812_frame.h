@@ -0,0 +1,34 @@
+#ifndef WS2812_FRAME_H
+#define WS2812_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ws2812_encode.h"
+
+// Whole-frame pixel kernels.
+// Each one has a NEON version (WS2812_HAVE_NEON) and a portable scalar
+// version. The _scalar functions are always built so the NEON output can be
+// checked against them on the board.
+
+// "neon" or "scalar": which kernels this build uses
+const char *ws2812_simd_name(void);
+
+// count R-G-B pixels -> G-R-B. dst and src may be the same buffer.
+void ws2812_rgb_to_grb(uint8_t *dst, const uint8_t *src, size_t count);
+void ws2812_rgb_to_grb_scalar(uint8_t *dst, const uint8_t *src, size_t count);
+
+// Scale len bytes in place by a brightness level, as ws2812_scale8().
+void ws2812_scale_frame(uint8_t *buf, size_t len, uint8_t level);
+void ws2812_scale_frame_scalar(uint8_t *buf, size_t len, uint8_t level);
+
+// Map len bytes in place through a 256-entry table (gamma, correction ...).
+void ws2812_lut_frame(uint8_t *buf, size_t len, const uint8_t lut[256]);
+void ws2812_lut_frame_scalar(uint8_t *buf, size_t len, const uint8_t lut[256]);
+
+// Map count 3-byte pixels from src to dst with a separate table per channel
+// (lut[0] for the first byte of each pixel ...). dst may equal src.
+void ws2812_lut3_frame(uint8_t *dst, const uint8_t *src, size_t count, const uint8_t lut[3][256]);
+void ws2812_lut3_frame_scalar(uint8_t *dst, const uint8_t *src, size_t count, const uint8_t lut[3][256]);
+
+#endif
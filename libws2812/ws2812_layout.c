@@ -0,0 +1,128 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ws2812_layout.h"
+
+void ws2812_layout_default(struct ws2812_layout_config *c) {
+    c->panel_width = 8;
+    c->panel_height = 8;
+    c->panels_x = 1;
+    c->panels_y = 1;
+    c->wiring = WS2812_ORDER_ROWS;
+    c->chain = WS2812_ORDER_ROWS;
+    c->rotate = 0;
+}
+
+static int parse_order(const char *s, enum ws2812_order *order) {
+    if (strcmp(s, "rows") == 0) {
+        *order = WS2812_ORDER_ROWS;
+    } else if (strcmp(s, "serpentine") == 0) {
+        *order = WS2812_ORDER_SERPENTINE;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static int parse_size(const char *s, int *w, int *h) {
+    char end;
+    if (sscanf(s, "%dx%d%c", w, h, &end) != 2) return -1;
+    return (*w > 0 && *h > 0) ? 0 : -1;
+}
+
+void ws2812_layout_from_env(struct ws2812_layout_config *c) {
+    const char *env = getenv("WS2812_LAYOUT");
+    if (env == NULL) return;
+
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", env);
+
+    char *save = NULL;
+    for (char *item = strtok_r(buf, ",", &save); item != NULL; item = strtok_r(NULL, ",", &save)) {
+        char *val = strchr(item, '=');
+        int ok = -1;
+
+        if (val != NULL) {
+            *val++ = '\0';
+            struct ws2812_layout_config n = *c;
+
+            if (strcmp(item, "panel") == 0) {
+                ok = parse_size(val, &n.panel_width, &n.panel_height);
+            } else if (strcmp(item, "panels") == 0) {
+                ok = parse_size(val, &n.panels_x, &n.panels_y);
+            } else if (strcmp(item, "wiring") == 0) {
+                ok = parse_order(val, &n.wiring);
+            } else if (strcmp(item, "chain") == 0) {
+                ok = parse_order(val, &n.chain);
+            } else if (strcmp(item, "rotate") == 0) {
+                n.rotate = atoi(val);
+                ok = (n.rotate % 90 == 0 && n.rotate >= 0 && n.rotate < 360) ? 0 : -1;
+            }
+            if (ok == 0) *c = n;
+        }
+        if (ok < 0) {
+            if (val != NULL) val[-1] = '=';
+            fprintf(stderr, "Ignoring WS2812_LAYOUT item '%s' (use panel=WxH, panels=XxY, "
+                    "wiring=rows|serpentine, chain=rows|serpentine, rotate=0|90|180|270)\n", item);
+        }
+    }
+}
+
+// Position inside a panel as wired, for a pixel at lx, ly of the panel as it
+// appears on the canvas
+static size_t panel_index(const struct ws2812_layout_config *c, int lx, int ly) {
+    int w = c->panel_width, h = c->panel_height;
+    int px, py;
+
+    switch (c->rotate) {
+        case 90:  px = ly;         py = h - 1 - lx; break;
+        case 180: px = w - 1 - lx; py = h - 1 - ly; break;
+        case 270: px = w - 1 - ly; py = lx;         break;
+        default:  px = lx;         py = ly;         break;
+    }
+
+    if (c->wiring == WS2812_ORDER_SERPENTINE && (py & 1)) px = w - 1 - px;
+    return (size_t)py * w + px;
+}
+
+int ws2812_layout_init(struct ws2812_layout *l, const struct ws2812_layout_config *c) {
+    memset(l, 0, sizeof(*l));
+    if (c->panel_width <= 0 || c->panel_height <= 0 || c->panels_x <= 0 || c->panels_y <= 0 ||
+        c->rotate % 90 != 0 || c->rotate < 0 || c->rotate >= 360) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Turned a quarter, a panel's rows become the canvas' columns
+    int sideways = (c->rotate == 90 || c->rotate == 270);
+    int cell_w = sideways ? c->panel_height : c->panel_width;
+    int cell_h = sideways ? c->panel_width : c->panel_height;
+    size_t per_panel = (size_t)c->panel_width * c->panel_height;
+
+    l->width = cell_w * c->panels_x;
+    l->height = cell_h * c->panels_y;
+    l->count = per_panel * c->panels_x * c->panels_y;
+    l->map = malloc(l->count * sizeof(*l->map));
+    if (l->map == NULL) return -1;
+
+    for (int y = 0; y < l->height; y++) {
+        int row = y / cell_h;
+        for (int x = 0; x < l->width; x++) {
+            int col = x / cell_w;
+            if (c->chain == WS2812_ORDER_SERPENTINE && (row & 1)) col = c->panels_x - 1 - col;
+
+            size_t panel = (size_t)row * c->panels_x + col;
+            l->map[(size_t)y * l->width + x] =
+                (uint32_t)(panel * per_panel + panel_index(c, x % cell_w, y % cell_h));
+        }
+    }
+    return 0;
+}
+
+void ws2812_layout_free(struct ws2812_layout *l) {
+    free(l->map);
+    l->map = NULL;
+    l->count = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef WS2812_LAYOUT_H
+#define WS2812_LAYOUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Physical layout of a chain built from identical panels ( 8x8 matrices ).
+// Patterns draw on an x, y canvas; the layout turns that into the LED's
+// position along the chain. The table is built once, so drawing costs one
+// lookup per pixel however the panels are wired.
+
+enum ws2812_order {
+    WS2812_ORDER_ROWS,          // every row runs left to right
+    WS2812_ORDER_SERPENTINE,    // odd rows run right to left
+};
+
+struct ws2812_layout_config {
+    int panel_width;            // LEDs per panel row, as wired
+    int panel_height;
+    int panels_x;               // panels across the canvas
+    int panels_y;               // panels down the canvas
+    enum ws2812_order wiring;   // LED order inside a panel
+    enum ws2812_order chain;    // order the data line visits the panels
+    int rotate;                 // 0, 90, 180, 270: panels mounted turned clockwise
+};
+
+struct ws2812_layout {
+    int width;                  // canvas size in LEDs
+    int height;
+    size_t count;               // LEDs in the chain
+    uint32_t *map;              // map[y * width + x] = index along the chain
+};
+
+// One 8x8 panel, rows left to right: index = y * 8 + x
+void ws2812_layout_default(struct ws2812_layout_config *c);
+
+// Override c from WS2812_LAYOUT, comma separated, any subset of
+//   panel=8x8,panels=4x2,wiring=serpentine,chain=rows,rotate=90
+// Bad values are reported on stderr and ignored.
+void ws2812_layout_from_env(struct ws2812_layout_config *c);
+
+// Build the canvas -> chain table for c.
+// Returns 0, or -1 with errno set (EINVAL for a bad config).
+int ws2812_layout_init(struct ws2812_layout *l, const struct ws2812_layout_config *c);
+
+void ws2812_layout_free(struct ws2812_layout *l);
+
+// Chain index of canvas pixel x, y; l->count (ignored by ws2812_set_pixel)
+// when it is off the canvas.
+static inline size_t ws2812_layout_index(const struct ws2812_layout *l, int x, int y) {
+    if (x < 0 || y < 0 || x >= l->width || y >= l->height) return l->count;
+    return l->map[(size_t)y * l->width + x];
+}
+
+#endif
@@ -0,0 +1,152 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ws2812_map.h"
+
+static int alloc_map(struct ws2812_map *m, int width, int height) {
+    memset(m, 0, sizeof(*m));
+    if (width <= 0 || height <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    m->width = width;
+    m->height = height;
+    m->count = (size_t)width * height;
+    m->index = malloc(m->count * sizeof(*m->index));
+    return m->index != NULL ? 0 : -1;
+}
+
+int ws2812_map_identity(struct ws2812_map *m, int width, int height) {
+    if (alloc_map(m, width, height) < 0) return -1;
+    for (size_t i = 0; i < m->count; i++) m->index[i] = (uint32_t)i;
+    return 0;
+}
+
+int ws2812_map_serpentine(struct ws2812_map *m, int width, int height) {
+    if (alloc_map(m, width, height) < 0) return -1;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int sx = (y & 1) ? width - 1 - x : x;
+            m->index[(size_t)y * width + x] = (uint32_t)((size_t)y * width + sx);
+        }
+    }
+    return 0;
+}
+
+int ws2812_map_spiral(struct ws2812_map *m, int width, int height) {
+    if (alloc_map(m, width, height) < 0) return -1;
+
+    // Walk the ring between these bounds, then shrink it
+    int left = 0, top = 0, right = width - 1, bottom = height - 1;
+    size_t n = 0;
+
+    while (left <= right && top <= bottom) {
+        for (int x = left; x <= right; x++) m->index[n++] = (uint32_t)(top * width + x);
+        for (int y = top + 1; y <= bottom; y++) m->index[n++] = (uint32_t)(y * width + right);
+        if (top < bottom) {
+            for (int x = right - 1; x >= left; x--) m->index[n++] = (uint32_t)(bottom * width + x);
+        }
+        if (left < right) {
+            for (int y = bottom - 1; y > top; y--) m->index[n++] = (uint32_t)(y * width + left);
+        }
+        left++;
+        top++;
+        right--;
+        bottom--;
+    }
+    return 0;
+}
+
+int ws2812_map_rotate(struct ws2812_map *m, int width, int height, int degrees) {
+    if (degrees % 90 != 0 || degrees < 0 || degrees >= 360) {
+        memset(m, 0, sizeof(*m));
+        errno = EINVAL;
+        return -1;
+    }
+
+    int sideways = (degrees == 90 || degrees == 270);
+    int w = sideways ? height : width;
+    int h = sideways ? width : height;
+    if (alloc_map(m, w, h) < 0) return -1;
+
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int sx, sy;
+            switch (degrees) {
+                case 90:  sx = y;             sy = height - 1 - x; break;
+                case 180: sx = width - 1 - x; sy = height - 1 - y; break;
+                case 270: sx = width - 1 - y; sy = x;              break;
+                default:  sx = x;             sy = y;              break;
+            }
+            m->index[(size_t)y * w + x] = (uint32_t)((size_t)sy * width + sx);
+        }
+    }
+    return 0;
+}
+
+int ws2812_map_mirror(struct ws2812_map *m, int width, int height, int flip_x, int flip_y) {
+    if (alloc_map(m, width, height) < 0) return -1;
+    for (int y = 0; y < height; y++) {
+        int sy = flip_y ? height - 1 - y : y;
+        for (int x = 0; x < width; x++) {
+            int sx = flip_x ? width - 1 - x : x;
+            m->index[(size_t)y * width + x] = (uint32_t)((size_t)sy * width + sx);
+        }
+    }
+    return 0;
+}
+
+int ws2812_map_mask(struct ws2812_map *m, int width, int height,
+                    const uint8_t *mask, int mask_width, int mask_height) {
+    if (mask_width <= 0 || mask_height <= 0) {
+        memset(m, 0, sizeof(*m));
+        errno = EINVAL;
+        return -1;
+    }
+    if (alloc_map(m, width, height) < 0) return -1;
+
+    uint32_t off = (uint32_t)m->count;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            size_t cell = (size_t)y * width + x;
+            m->index[cell] = mask[(y % mask_height) * mask_width + x % mask_width] ? (uint32_t)cell : off;
+        }
+    }
+    return 0;
+}
+
+int ws2812_map_layout(struct ws2812_map *m, const struct ws2812_layout *l) {
+    if (alloc_map(m, l->width, l->height) < 0) return -1;
+    for (size_t cell = 0; cell < m->count; cell++) m->index[l->map[cell]] = (uint32_t)cell;
+    return 0;
+}
+
+int ws2812_map_compose(struct ws2812_map *dst, const struct ws2812_map *first, const struct ws2812_map *second) {
+    memset(dst, 0, sizeof(*dst));
+    dst->index = malloc((second->count ? second->count : 1) * sizeof(*dst->index));
+    if (dst->index == NULL) return -1;
+
+    dst->width = second->width;
+    dst->height = second->height;
+    dst->count = second->count;
+    // Entries past the end of 'first' (a mask's "off" cell) stay as they are
+    for (size_t i = 0; i < second->count; i++) {
+        uint32_t j = second->index[i];
+        dst->index[i] = j < first->count ? first->index[j] : (uint32_t)first->count;
+    }
+    return 0;
+}
+
+void ws2812_map_chain(struct ws2812_map *m, const struct ws2812_layout *l) {
+    for (size_t i = 0; i < m->count; i++) {
+        uint32_t cell = m->index[i];
+        m->index[i] = cell < (size_t)l->width * l->height ? l->map[cell] : (uint32_t)l->count;
+    }
+}
+
+void ws2812_map_free(struct ws2812_map *m) {
+    free(m->index);
+    m->index = NULL;
+    m->count = 0;
+}
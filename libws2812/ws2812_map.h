@@ -0,0 +1,73 @@
+#ifndef WS2812_MAP_H
+#define WS2812_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ws2812_layout.h"
+
+// Index maps for spatial patterns.
+// A map is a flat table built once at startup: entry i names the cell (or
+// LED) that element i takes its pixel from, so a frame is drawn with one
+// gather
+//
+//   dst[i] = src[map.index[i]]
+//
+// and no per-pixel geometry or branches. Cells are numbered y * width + x.
+// Maps of the same shape compose, e.g. rotate, then mirror, then the panel
+// layout, into a single table.
+struct ws2812_map {
+    int width;              // grid the map's entries are laid out on
+    int height;
+    size_t count;           // entries in index
+    uint32_t *index;
+};
+
+// Every generator returns 0, or -1 with errno set (EINVAL for a bad size).
+
+// Cells in row order: the map that changes nothing
+int ws2812_map_identity(struct ws2812_map *m, int width, int height);
+
+// Cells in row order with every odd row right to left
+int ws2812_map_serpentine(struct ws2812_map *m, int width, int height);
+
+// Cells from the top left corner clockwise around the edge, spiralling in
+int ws2812_map_spiral(struct ws2812_map *m, int width, int height);
+
+// Turn a width x height source clockwise by 0, 90, 180 or 270 degrees.
+// A quarter turn gives a height x width map.
+int ws2812_map_rotate(struct ws2812_map *m, int width, int height, int degrees);
+
+// Flip a width x height source left-right and/or top-bottom
+int ws2812_map_mirror(struct ws2812_map *m, int width, int height, int flip_x, int flip_y);
+
+// Keep the cells where mask (mask_width x mask_height, tiled over the grid)
+// is non-zero. The others point at cell width * height, one past the last:
+// give the source an extra black pixel there.
+int ws2812_map_mask(struct ws2812_map *m, int width, int height,
+                    const uint8_t *mask, int mask_width, int mask_height);
+
+// Chain order: entry i is the canvas cell LED i shows, for gathering a
+// canvas straight into the device's pixel buffer.
+int ws2812_map_layout(struct ws2812_map *m, const struct ws2812_layout *l);
+
+// dst[i] = first[second[i]]: 'second' picks from what 'first' produces.
+// Gathering through dst is the same as gathering through first, then second.
+int ws2812_map_compose(struct ws2812_map *dst, const struct ws2812_map *first, const struct ws2812_map *second);
+
+// Turn the cell numbers in m into LED indexes on the chain (in place).
+void ws2812_map_chain(struct ws2812_map *m, const struct ws2812_layout *l);
+
+void ws2812_map_free(struct ws2812_map *m);
+
+// dst[i] = src[index[i]] for m->count 3-byte pixels
+static inline void ws2812_map_gather(uint8_t *dst, const uint8_t *src, const struct ws2812_map *m) {
+    for (size_t i = 0; i < m->count; i++) {
+        const uint8_t *p = src + (size_t)m->index[i] * 3;
+        dst[i * 3]     = p[0];
+        dst[i * 3 + 1] = p[1];
+        dst[i * 3 + 2] = p[2];
+    }
+}
+
+#endif
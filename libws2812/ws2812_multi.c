@@ -0,0 +1,187 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ws2812_multi.h"
+
+static void do_job(struct ws2812_multi_output *out, enum ws2812_multi_job job, const uint8_t *grb) {
+    if (job == WS2812_MULTI_ENCODE) {
+        out->changed = ws2812_encode_frame_from(&out->dev, grb + out->first * 3);
+    } else if (job == WS2812_MULTI_FLUSH) {
+        out->failed = ws2812_flush(&out->dev) < 0;
+        out->err = out->failed ? errno : 0;
+    }
+}
+
+static void *output_main(void *arg) {
+    struct ws2812_multi_output *out = arg;
+    struct ws2812_multi *m = out->multi;
+
+    pthread_mutex_lock(&m->lock);
+    while (1) {
+        while (m->generation == out->seen) pthread_cond_wait(&m->go, &m->lock);
+        out->seen = m->generation;
+        if (m->job == WS2812_MULTI_STOP) break;
+
+        enum ws2812_multi_job job = m->job;
+        const uint8_t *grb = m->grb;
+        pthread_mutex_unlock(&m->lock);
+
+        do_job(out, job, grb);
+
+        pthread_mutex_lock(&m->lock);
+        if (--m->pending == 0) pthread_cond_signal(&m->idle);
+    }
+    pthread_mutex_unlock(&m->lock);
+    return NULL;
+}
+
+static void stop_threads(struct ws2812_multi *m, int count) {
+    pthread_mutex_lock(&m->lock);
+    m->job = WS2812_MULTI_STOP;
+    m->generation++;
+    pthread_cond_broadcast(&m->go);
+    pthread_mutex_unlock(&m->lock);
+
+    for (int i = 0; i < count; i++) pthread_join(m->out[i].thread, NULL);
+}
+
+// The threads are created by the first frame rather than at open, so they
+// inherit the scheduling of the thread that sends frames: programs switch to
+// SCHED_FIFO after opening the device, and the pipeline writer sends from
+// its own thread.
+static int start_threads(struct ws2812_multi *m) {
+    for (int i = 0; i < m->count; i++) {
+        m->out[i].seen = m->generation;
+        int err = pthread_create(&m->out[i].thread, NULL, output_main, &m->out[i]);
+        if (err != 0) {
+            stop_threads(m, i);
+            errno = err;
+            return -1;
+        }
+    }
+    m->running = 1;
+    return 0;
+}
+
+// Tried once: if the threads can't be had, every frame fails with the same
+// error instead of trying again in the frame path
+static int run(struct ws2812_multi *m, enum ws2812_multi_job job, const uint8_t *grb) {
+    if (m->running == 0 && start_threads(m) < 0) {
+        m->start_err = errno;
+        m->running = -1;
+        fprintf(stderr, "ws2812: can't start output threads: %s\n", strerror(m->start_err));
+    }
+    if (m->running < 0) {
+        errno = m->start_err;
+        return -1;
+    }
+
+    pthread_mutex_lock(&m->lock);
+    m->job = job;
+    m->grb = grb;
+    m->pending = m->count;
+    m->generation++;
+    pthread_cond_broadcast(&m->go);
+    while (m->pending > 0) pthread_cond_wait(&m->idle, &m->lock);
+    pthread_mutex_unlock(&m->lock);
+    return 0;
+}
+
+// LEDs [first, first + count) of the whole chain go to output i
+static void share(size_t led_count, int outputs, int i, size_t *first, size_t *count) {
+    size_t begin = led_count * i / outputs;
+    size_t end = led_count * (i + 1) / outputs;
+    *first = begin;
+    *count = end - begin;
+}
+
+struct ws2812_multi *ws2812_multi_open(const char *paths, size_t led_count, enum ws2812_mode mode) {
+    char list[512];
+    char *path[WS2812_MULTI_MAX];
+    int n = 0;
+
+    snprintf(list, sizeof(list), "%s", paths);
+    char *save = NULL;
+    for (char *p = strtok_r(list, ",", &save); p != NULL; p = strtok_r(NULL, ",", &save)) {
+        if (n == WS2812_MULTI_MAX) {
+            errno = E2BIG;
+            return NULL;
+        }
+        path[n++] = p;
+    }
+    if (n == 0) {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    struct ws2812_multi *m = calloc(1, sizeof(*m));
+    if (m == NULL) return NULL;
+
+    for (int i = 0; i < n; i++) {
+        struct ws2812_multi_output *out = &m->out[i];
+        size_t count;
+
+        share(led_count, n, i, &out->first, &count);
+        out->multi = m;
+        if (ws2812_open(&out->dev, path[i], count, mode) < 0) goto fail;
+        // Whether a frame is sent at all is decided for the whole chain
+        ws2812_set_keepalive(&out->dev, 0);
+        m->count++;
+    }
+
+    pthread_mutex_init(&m->lock, NULL);
+    pthread_cond_init(&m->go, NULL);
+    pthread_cond_init(&m->idle, NULL);
+    return m;
+
+fail:;
+    int err = errno;
+    for (int i = 0; i < m->count; i++) ws2812_close(&m->out[i].dev);
+    free(m);
+    errno = err;
+    return NULL;
+}
+
+int ws2812_multi_resize(struct ws2812_multi *m, size_t led_count) {
+    for (int i = 0; i < m->count; i++) {
+        size_t count;
+        share(led_count, m->count, i, &m->out[i].first, &count);
+        if (ws2812_resize(&m->out[i].dev, count) < 0) return -1;
+    }
+    return 0;
+}
+
+size_t ws2812_multi_encode(struct ws2812_multi *m, const uint8_t *grb) {
+    size_t changed = 0;
+
+    // Nothing encoded: call it all changed, so the flush reports the error
+    int ok = run(m, WS2812_MULTI_ENCODE, grb) == 0;
+    for (int i = 0; i < m->count; i++) changed += ok ? m->out[i].changed : m->out[i].dev.led_count * 3;
+    return changed;
+}
+
+int ws2812_multi_flush(struct ws2812_multi *m) {
+    if (run(m, WS2812_MULTI_FLUSH, NULL) < 0) return -1;
+    for (int i = 0; i < m->count; i++) {
+        if (m->out[i].failed) {
+            errno = m->out[i].err;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void ws2812_multi_set_correction(struct ws2812_multi *m, const struct ws2812_correction *c) {
+    for (int i = 0; i < m->count; i++) ws2812_set_correction(&m->out[i].dev, c);
+}
+
+void ws2812_multi_close(struct ws2812_multi *m) {
+    if (m->running > 0) stop_threads(m, m->count);
+    pthread_mutex_destroy(&m->lock);
+    pthread_cond_destroy(&m->go);
+    pthread_cond_destroy(&m->idle);
+    for (int i = 0; i < m->count; i++) ws2812_close(&m->out[i].dev);
+    free(m);
+}
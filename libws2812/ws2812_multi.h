@@ -0,0 +1,77 @@
+#ifndef WS2812_MULTI_H
+#define WS2812_MULTI_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ws2812.h"
+
+// Multi-output: one frame split across several chains, one per SPI bus.
+// ws2812_open() builds one when the device path is a comma separated list
+//
+//   WS2812_DEVICE=/dev/spidev0.0,/dev/spidev1.0
+//
+// and the device then behaves as a single chain of all their LEDs: output k
+// drives the k-th equal share of the pixel buffer, in order. Each output has
+// a thread that encodes and sends its share, so buses run concurrently and
+// a frame is only done once every bus has sent it.
+#define WS2812_MULTI_MAX 8
+
+enum ws2812_multi_job {
+    WS2812_MULTI_ENCODE,
+    WS2812_MULTI_FLUSH,
+    WS2812_MULTI_STOP,
+};
+
+struct ws2812_multi;
+
+struct ws2812_multi_output {
+    struct ws2812_multi *multi;
+    struct ws2812 dev;      // this bus' chain and encode buffers
+    size_t first;           // its first LED in the parent's pixel buffer
+    size_t changed;         // result of the last encode
+    int failed;             // last flush failed (errno in err)
+    int err;
+    unsigned seen;          // last generation this output's thread picked up
+    pthread_t thread;
+};
+
+struct ws2812_multi {
+    int count;
+    struct ws2812_multi_output out[WS2812_MULTI_MAX];
+
+    // Work for the current frame. Bumping the generation hands it to every
+    // thread; the caller sleeps on 'idle' until 'pending' is back to 0.
+    pthread_mutex_t lock;
+    pthread_cond_t go, idle;
+    unsigned generation;
+    int pending;
+    enum ws2812_multi_job job;
+    const uint8_t *grb;
+    int running;            // threads are started by the first frame: 1, or
+    int start_err;          // -1 if they could not be, with the errno here
+};
+
+// Open every output in the comma separated 'paths' and split led_count LEDs
+// between them. Returns NULL with errno set on failure.
+struct ws2812_multi *ws2812_multi_open(const char *paths, size_t led_count, enum ws2812_mode mode);
+
+// Re-split the LEDs after the parent's count changed.
+int ws2812_multi_resize(struct ws2812_multi *m, size_t led_count);
+
+// Encode each output's share of grb in parallel.
+// Returns the number of changed GRB bytes over all outputs. If the output
+// threads could not be started (said once on stderr, by the first frame)
+// nothing is encoded and every byte counts as changed.
+size_t ws2812_multi_encode(struct ws2812_multi *m, const uint8_t *grb);
+
+// Send every output's encoded frame in parallel. Returns 0, or -1 with errno
+// set from the first output that failed, or from starting the threads.
+int ws2812_multi_flush(struct ws2812_multi *m);
+
+void ws2812_multi_set_correction(struct ws2812_multi *m, const struct ws2812_correction *c);
+
+void ws2812_multi_close(struct ws2812_multi *m);
+
+#endif
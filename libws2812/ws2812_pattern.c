@@ -0,0 +1,141 @@
+#include <dlfcn.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ws2812_pattern.h"
+
+void ws2812_engine_init(struct ws2812_engine *e, struct ws2812 *dev, const struct ws2812_layout *l) {
+    memset(e, 0, sizeof(*e));
+    e->dev = dev;
+    e->layout = l;
+    e->from = -1;
+}
+
+int ws2812_engine_add(struct ws2812_engine *e, const struct ws2812_pattern *p) {
+    if (e->count == WS2812_MAX_PATTERNS) {
+        errno = ENOSPC;
+        return -1;
+    }
+
+    struct ws2812_pattern_slot *s = &e->slots[e->count];
+    memset(s, 0, sizeof(*s));
+    s->pattern = p;
+    s->pixels = calloc(e->dev->led_count ? e->dev->led_count : 1, 3);
+    if (s->pixels == NULL) return -1;
+
+    if (p->init != NULL && p->init(&s->state, e->layout) < 0) {
+        int err = errno;
+        free(s->pixels);
+        errno = err;
+        return -1;
+    }
+    return e->count++;
+}
+
+int ws2812_engine_load(struct ws2812_engine *e, const char *path) {
+    void *dl = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (dl == NULL) {
+        fprintf(stderr, "Can't load %s: %s\n", path, dlerror());
+        return -1;
+    }
+
+    const struct ws2812_pattern *p = dlsym(dl, WS2812_PATTERN_SYMBOL);
+    if (p == NULL || p->name == NULL || p->render == NULL) {
+        fprintf(stderr, "%s has no usable %s\n", path, WS2812_PATTERN_SYMBOL);
+        dlclose(dl);
+        return -1;
+    }
+
+    int index = ws2812_engine_add(e, p);
+    if (index < 0) {
+        perror(path);
+        dlclose(dl);
+        return -1;
+    }
+    e->slots[index].dl = dl;
+    return index;
+}
+
+int ws2812_engine_find(const struct ws2812_engine *e, const char *name) {
+    for (int i = 0; i < e->count; i++) {
+        if (strcmp(e->slots[i].pattern->name, name) == 0) return i;
+    }
+    return -1;
+}
+
+void ws2812_engine_switch(struct ws2812_engine *e, int index, enum ws2812_transition t, uint32_t frames) {
+    if (index == e->current) return;
+    if (t == WS2812_TRANSITION_CUT || frames == 0) {
+        e->from = -1;
+    } else {
+        e->from = e->current;
+        e->transition = t;
+        e->frames = frames;
+        e->frame = 0;
+    }
+    e->current = index;
+}
+
+void ws2812_engine_set_wipe(struct ws2812_engine *e, const struct ws2812_map *path) {
+    e->wipe = path;
+}
+
+// The pattern draws on its own frame through the usual pixel calls
+static const uint8_t *render_slot(struct ws2812_engine *e, int index) {
+    struct ws2812 *dev = e->dev;
+    struct ws2812_pattern_slot *s = &e->slots[index];
+    uint8_t *out = dev->pixels;
+
+    dev->pixels = s->pixels;
+    s->pattern->render(s->state, dev, e->layout, s->t++);
+    dev->pixels = out;
+    return s->pixels;
+}
+
+// The front runs from 0 to count + edge along the path: LEDs behind the
+// edge show b, LEDs ahead of it a, and the edge itself ramps between them
+static void wipe(uint8_t *dst, const uint8_t *a, const uint8_t *b, const struct ws2812_map *path,
+                 size_t count, uint32_t frame, uint32_t frames) {
+    size_t edge = count / 8 + 1;
+    size_t front = (count + edge) * frame / frames;
+    size_t steps = path ? path->count : count;
+
+    for (size_t i = 0; i < steps; i++) {
+        size_t led = path ? path->index[i] : i;
+        if (led >= count) continue;
+        size_t w = front > i ? (front - i) * 256 / edge : 0;
+        if (w > 256) w = 256;
+        ws2812_crossfade(dst + led * 3, a + led * 3, b + led * 3, 3, (unsigned)w);
+    }
+}
+
+void ws2812_engine_render(struct ws2812_engine *e) {
+    struct ws2812 *dev = e->dev;
+    const uint8_t *next = render_slot(e, e->current);
+
+    if (e->from < 0) {
+        memcpy(dev->pixels, next, dev->led_count * 3);
+        return;
+    }
+
+    const uint8_t *prev = render_slot(e, e->from);
+    e->frame++;
+    if (e->transition == WS2812_TRANSITION_WIPE) {
+        wipe(dev->pixels, prev, next, e->wipe, dev->led_count, e->frame, e->frames);
+    } else {
+        ws2812_crossfade(dev->pixels, prev, next, dev->led_count * 3, e->frame * 256 / e->frames);
+    }
+    if (e->frame == e->frames) e->from = -1;
+}
+
+void ws2812_engine_free(struct ws2812_engine *e) {
+    for (int i = 0; i < e->count; i++) {
+        struct ws2812_pattern_slot *s = &e->slots[i];
+        if (s->pattern->fini != NULL) s->pattern->fini(s->state);
+        free(s->pixels);
+        if (s->dl != NULL) dlclose(s->dl);
+    }
+    e->count = 0;
+}
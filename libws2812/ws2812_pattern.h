@@ -0,0 +1,90 @@
+#ifndef WS2812_PATTERN_H
+#define WS2812_PATTERN_H
+
+#include <stdint.h>
+
+#include "ws2812.h"
+
+// Pattern engine: animations as small modules driven by one long-running
+// process that keeps the device open.
+//
+// A pattern draws frame t into dev->pixels, which holds its own previous
+// frame (so moving things only need to erase what they leave). Each pattern
+// added to an engine is initialised and given its own frame buffer up
+// front, so selecting it later costs nothing but a pointer change.
+struct ws2812_pattern {
+    const char *name;
+    long period_us;         // frame period the pattern was written for
+
+    // Build per-layout state (maps, sprites). May be NULL. Returns 0, or -1
+    // with errno set.
+    int (*init)(void **state, const struct ws2812_layout *l);
+
+    // Draw frame t (frames this pattern has rendered)
+    void (*render)(void *state, struct ws2812 *dev, const struct ws2812_layout *l, uint32_t t);
+
+    void (*fini)(void *state);  // may be NULL
+};
+
+// A .so pattern exports its struct ws2812_pattern under this name
+#define WS2812_PATTERN_SYMBOL "ws2812_pattern_module"
+
+#define WS2812_MAX_PATTERNS 32
+
+struct ws2812_pattern_slot {
+    const struct ws2812_pattern *pattern;
+    void *state;
+    uint8_t *pixels;        // the pattern's own frame, kept between frames
+    uint32_t t;
+    void *dl;               // dlopen() handle for loaded modules
+};
+
+// How ws2812_engine_switch() goes from one pattern to the next. Both
+// patterns keep running for the length of the transition.
+enum ws2812_transition {
+    WS2812_TRANSITION_CUT,          // next frame is the new pattern
+    WS2812_TRANSITION_CROSSFADE,    // whole frame fades from old to new
+    WS2812_TRANSITION_WIPE,         // new pattern sweeps in along the wipe path
+};
+
+struct ws2812_engine {
+    struct ws2812 *dev;
+    const struct ws2812_layout *layout;
+    struct ws2812_pattern_slot slots[WS2812_MAX_PATTERNS];
+    int count;
+    int current;
+
+    // Transition in progress: from is the outgoing pattern, or -1
+    int from;
+    enum ws2812_transition transition;
+    uint32_t frames, frame;
+    const struct ws2812_map *wipe;  // chain indexes in wipe order, NULL = chain order
+};
+
+void ws2812_engine_init(struct ws2812_engine *e, struct ws2812 *dev, const struct ws2812_layout *l);
+
+// Add a pattern (initialising it now). Returns its index, or -1 with errno set.
+int ws2812_engine_add(struct ws2812_engine *e, const struct ws2812_pattern *p);
+
+// dlopen() a pattern module and add it. Returns its index, or -1 (the reason
+// is printed on stderr).
+int ws2812_engine_load(struct ws2812_engine *e, const char *path);
+
+// Index of the pattern called name, or -1
+int ws2812_engine_find(const struct ws2812_engine *e, const char *name);
+
+// Make pattern index current, blending into it over frames frames. A switch
+// during a transition starts the new one from the pattern being faded in.
+void ws2812_engine_switch(struct ws2812_engine *e, int index, enum ws2812_transition t, uint32_t frames);
+
+// Path for WS2812_TRANSITION_WIPE ( e.g. a chained spiral or column map ).
+// Must cover every LED once; the engine keeps the pointer.
+void ws2812_engine_set_wipe(struct ws2812_engine *e, const struct ws2812_map *path);
+
+// Draw the current pattern's next frame into dev->pixels. During a
+// transition both patterns render and the frame is their blend.
+void ws2812_engine_render(struct ws2812_engine *e);
+
+void ws2812_engine_free(struct ws2812_engine *e);
+
+#endif
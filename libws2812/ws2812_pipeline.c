@@ -0,0 +1,178 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ws2812_pipeline.h"
+#include "ws2812_shm.h"
+
+static uint8_t *slot(struct ws2812_pipeline *pipe, unsigned index) {
+    return pipe->slots[index % WS2812_PIPELINE_DEPTH];
+}
+
+static void *writer_main(void *arg) {
+    struct ws2812_pipeline *pipe = arg;
+    struct ws2812 *dev = pipe->dev;
+
+    while (1) {
+        while (sem_wait(&pipe->ready) < 0 && errno == EINTR) {
+        }
+        if (atomic_load(&pipe->stop)) break;
+
+        unsigned tail = atomic_load_explicit(&pipe->tail, memory_order_relaxed);
+        unsigned head = atomic_load_explicit(&pipe->head, memory_order_acquire);
+        unsigned depth = head - tail;
+        if (depth > atomic_load_explicit(&pipe->max_depth, memory_order_relaxed)) {
+            atomic_store_explicit(&pipe->max_depth, depth, memory_order_relaxed);
+        }
+
+        // Only the newest frame matters: let go of any older ones queued
+        // behind it while the last transfer was running
+        while (depth > 1 && sem_trywait(&pipe->ready) == 0) {
+            tail++;
+            depth--;
+            atomic_store_explicit(&pipe->tail, tail, memory_order_release);
+            atomic_fetch_add_explicit(&pipe->dropped, 1, memory_order_relaxed);
+            sem_post(&pipe->free);
+        }
+
+        size_t changed = ws2812_encode_frame_from(dev, slot(pipe, tail));
+        atomic_store_explicit(&pipe->tail, tail + 1, memory_order_release);
+        sem_post(&pipe->free);
+
+        if (!ws2812_should_flush(dev, changed)) {
+            atomic_fetch_add_explicit(&pipe->skipped, 1, memory_order_relaxed);
+            if (dev->stats != NULL) atomic_fetch_add_explicit(&dev->stats->skipped, 1, memory_order_relaxed);
+            continue;
+        }
+        if (ws2812_flush(dev) < 0) {
+            atomic_fetch_add_explicit(&pipe->errors, 1, memory_order_relaxed);
+        } else {
+            atomic_fetch_add_explicit(&pipe->sent, 1, memory_order_relaxed);
+        }
+    }
+    return NULL;
+}
+
+int ws2812_pipeline_start(struct ws2812_pipeline *pipe, struct ws2812 *dev) {
+    size_t len = dev->led_count * 3;
+
+    memset(pipe, 0, sizeof(*pipe));
+    pipe->dev = dev;
+    pipe->own_pixels = dev->pixels;
+
+    // The LED daemon already runs the encode/transmit side in its own
+    // process: frames are drawn straight into its shared buffer
+    if (dev->shm != NULL) return 0;
+
+    // Every slot starts out as the current picture
+    for (int i = 0; i < WS2812_PIPELINE_DEPTH; i++) {
+        pipe->slots[i] = malloc(len ? len : 1);
+        if (pipe->slots[i] == NULL) goto fail;
+        memcpy(pipe->slots[i], dev->pixels, len);
+    }
+
+    atomic_init(&pipe->head, 0);
+    atomic_init(&pipe->tail, 0);
+    atomic_init(&pipe->stop, 0);
+    sem_init(&pipe->ready, 0, 0);
+    sem_init(&pipe->free, 0, WS2812_PIPELINE_DEPTH);
+
+    int err = pthread_create(&pipe->writer, NULL, writer_main, pipe);
+    if (err != 0) {
+        sem_destroy(&pipe->ready);
+        sem_destroy(&pipe->free);
+        errno = err;
+        goto fail;
+    }
+    return 0;
+
+fail:
+    err = errno;
+    for (int i = 0; i < WS2812_PIPELINE_DEPTH; i++) free(pipe->slots[i]);
+    errno = err;
+    return -1;
+}
+
+static void start_render(struct ws2812_pipeline *pipe) {
+    pipe->rendering = 1;
+    if (pipe->dev->stats != NULL) pipe->render_start = ws2812_stats_now();
+}
+
+void ws2812_pipeline_begin(struct ws2812_pipeline *pipe) {
+    if (pipe->rendering) return;
+
+    if (pipe->dev->shm != NULL) {
+        pipe->dev->pixels = ws2812_shm_begin(pipe->dev->shm);
+        start_render(pipe);
+        return;
+    }
+
+    while (sem_wait(&pipe->free) < 0 && errno == EINTR) {
+    }
+
+    // The writer never touches a slot before it is submitted, and only the
+    // producer writes slots, so the previous one is safe to read here
+    unsigned head = atomic_load_explicit(&pipe->head, memory_order_relaxed);
+    uint8_t *next = slot(pipe, head);
+    memcpy(next, slot(pipe, head - 1), pipe->dev->led_count * 3);
+
+    pipe->dev->pixels = next;
+    start_render(pipe);
+}
+
+void ws2812_pipeline_submit(struct ws2812_pipeline *pipe) {
+    if (!pipe->rendering) return;
+
+    pipe->rendering = 0;
+    atomic_fetch_add_explicit(&pipe->submitted, 1, memory_order_relaxed);
+
+    struct ws2812_stats *stats = pipe->dev->stats;
+    if (stats != NULL) {
+        uint64_t now = ws2812_stats_now();
+        ws2812_stats_record(stats, WS2812_STAGE_RENDER, now - pipe->render_start);
+        if (pipe->last_submit != 0) ws2812_stats_record(stats, WS2812_STAGE_FRAME, now - pipe->last_submit);
+        pipe->last_submit = now;
+    }
+
+    if (pipe->dev->shm != NULL) {
+        ws2812_shm_publish(pipe->dev->shm);
+        atomic_fetch_add_explicit(&pipe->sent, 1, memory_order_relaxed);
+        return;
+    }
+
+    unsigned head = atomic_load_explicit(&pipe->head, memory_order_relaxed);
+    atomic_store_explicit(&pipe->head, head + 1, memory_order_release);
+    sem_post(&pipe->ready);
+}
+
+void ws2812_pipeline_get_stats(struct ws2812_pipeline *pipe, struct ws2812_pipeline_stats *stats) {
+    stats->submitted = atomic_load(&pipe->submitted);
+    stats->sent = atomic_load(&pipe->sent);
+    stats->dropped = atomic_load(&pipe->dropped);
+    stats->skipped = atomic_load(&pipe->skipped);
+    stats->errors = atomic_load(&pipe->errors);
+    stats->max_depth = atomic_load(&pipe->max_depth);
+}
+
+void ws2812_pipeline_stop(struct ws2812_pipeline *pipe) {
+    if (pipe->dev->shm != NULL) {
+        if (pipe->rendering) ws2812_shm_publish(pipe->dev->shm);
+        memcpy(pipe->own_pixels, pipe->dev->pixels, pipe->dev->led_count * 3);
+        pipe->dev->pixels = pipe->own_pixels;
+        return;
+    }
+
+    atomic_store(&pipe->stop, 1);
+    sem_post(&pipe->ready);
+    pthread_join(pipe->writer, NULL);
+
+    // Hand the last rendered frame back to the device's own buffer
+    unsigned head = atomic_load(&pipe->head);
+    uint8_t *last = pipe->rendering ? slot(pipe, head) : slot(pipe, head - 1);
+    memcpy(pipe->own_pixels, last, pipe->dev->led_count * 3);
+    pipe->dev->pixels = pipe->own_pixels;
+
+    sem_destroy(&pipe->ready);
+    sem_destroy(&pipe->free);
+    for (int i = 0; i < WS2812_PIPELINE_DEPTH; i++) free(pipe->slots[i]);
+}
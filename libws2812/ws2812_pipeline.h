@@ -0,0 +1,70 @@
+#ifndef WS2812_PIPELINE_H
+#define WS2812_PIPELINE_H
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "ws2812.h"
+
+// Slots in the ring: one being rendered, the rest queued or on the wire.
+// A power of two so the free running indexes stay valid when they wrap.
+#define WS2812_PIPELINE_DEPTH 4
+
+struct ws2812_pipeline_stats {
+    uint64_t submitted;     // frames handed to the writer
+    uint64_t sent;          // frames encoded and transmitted without error
+    uint64_t dropped;       // frames replaced by a newer one before being sent
+    uint64_t skipped;       // frames identical to what the LEDs already show
+    uint64_t errors;        // frames whose transfer failed (not in sent)
+    unsigned max_depth;     // most frames ever waiting for the writer
+};
+
+// Render/transmit pipeline.
+// The pattern renders frame N+1 on its own thread while a writer thread
+// encodes and sends frame N. Frames are handed over through a single-producer
+// single-consumer ring: the indexes are atomics and the two semaphores are
+// only there to sleep on, so neither side ever holds a lock.
+struct ws2812_pipeline {
+    struct ws2812 *dev;
+    uint8_t *own_pixels;    // dev->pixels before the pipeline took it over
+    uint8_t *slots[WS2812_PIPELINE_DEPTH];
+
+    atomic_uint head;       // next slot the producer fills (producer writes)
+    atomic_uint tail;       // next slot the writer sends (writer writes)
+    sem_t ready;            // frames queued for the writer
+    sem_t free;             // slots the producer may take
+    int rendering;          // producer holds slot head
+    atomic_bool stop;
+    pthread_t writer;
+
+    atomic_uint_fast64_t submitted, sent, dropped, skipped, errors;
+    atomic_uint max_depth;
+
+    // Producer side timestamps for dev->stats, ns
+    uint64_t render_start, last_submit;
+};
+
+// Start the writer thread for an open device. Until ws2812_pipeline_stop(),
+// the device must only be drawn on between begin() and submit(), and must
+// not be resized or shown directly. Returns 0, or -1 with errno set.
+// A "shm:" device needs no writer: begin() hands out the daemon's shared
+// back buffer and submit() publishes it.
+int ws2812_pipeline_start(struct ws2812_pipeline *pipe, struct ws2812 *dev);
+
+// Take a free slot to render into. dev->pixels points at it afterwards and
+// already holds the last submitted frame, so ws2812_set_pixel() and friends
+// work as usual. Blocks only if the writer is a whole ring behind.
+void ws2812_pipeline_begin(struct ws2812_pipeline *pipe);
+
+// Queue the slot taken by begin() for transmission.
+void ws2812_pipeline_submit(struct ws2812_pipeline *pipe);
+
+void ws2812_pipeline_get_stats(struct ws2812_pipeline *pipe, struct ws2812_pipeline_stats *stats);
+
+// Stop the writer (frames still queued are not sent) and give the device
+// back its own pixel buffer, holding the last frame rendered.
+void ws2812_pipeline_stop(struct ws2812_pipeline *pipe);
+
+#endif
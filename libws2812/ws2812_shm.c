@@ -0,0 +1,253 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "ws2812_shm.h"
+
+// A client waits this long for the daemon to finish with a frame before
+// drawing into it anyway: the daemon may have died mid-frame
+#define CLIENT_WAIT_MS 100
+
+static void futex_wait(_Atomic uint32_t *addr, uint32_t val, int timeout_ms) {
+    struct timespec ts = { timeout_ms / 1000, (timeout_ms % 1000) * 1000000L };
+    syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAIT, val, timeout_ms < 0 ? NULL : &ts, NULL, 0);
+}
+
+static void futex_wake(_Atomic uint32_t *addr) {
+    syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+static size_t frames_offset(void) {
+    return (sizeof(struct ws2812_shm_header) + 63) / 64 * 64;
+}
+
+static int map_shm(struct ws2812_shm *shm, size_t len) {
+    void *p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, shm->fd, 0);
+    if (p == MAP_FAILED) return -1;
+
+    // Not fatal: unprivileged users may hit RLIMIT_MEMLOCK
+    mlock(p, len);
+    shm->hdr = p;
+    shm->map_len = len;
+    return 0;
+}
+
+// A previous daemon's object of the same geometry is taken over as it is:
+// the client may have it mapped and keep drawing, so nothing is resized or
+// cleared. Only the daemon's half of the handshake starts over. It must be
+// ours and open to no one mode does not allow - the daemon trusts the
+// header - or it is replaced.
+static int reuse_shm(struct ws2812_shm *shm, size_t frame_len, size_t led_count, int width, int height, mode_t mode) {
+    size_t len = frames_offset() + 2 * frame_len;
+    struct stat st;
+
+    if (fstat(shm->fd, &st) < 0 || st.st_uid != geteuid() || (st.st_mode & 0777 & ~mode) != 0 ||
+        (size_t)st.st_size != len || map_shm(shm, len) < 0) return -1;
+
+    struct ws2812_shm_header *h = shm->hdr;
+    if (h->magic != WS2812_SHM_MAGIC || h->version != WS2812_SHM_VERSION || h->led_count != led_count ||
+        h->width != (uint32_t)width || h->height != (uint32_t)height ||
+        h->frame_offset[0] != frames_offset() || h->frame_offset[1] != frames_offset() + frame_len) {
+        munmap(shm->hdr, shm->map_len);
+        shm->hdr = NULL;
+        return -1;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    shm->frame[0] = (uint8_t *)h + h->frame_offset[0];
+    shm->frame[1] = (uint8_t *)h + h->frame_offset[1];
+
+    // The old daemon may have died holding a frame; show the front one again
+    atomic_store(&h->daemon_waiting, 0);
+    ws2812_shm_release(shm);
+    shm->last_seq = atomic_load(&h->seq) - 1;
+    return 0;
+}
+
+int ws2812_shm_create(struct ws2812_shm *shm, const char *name, size_t led_count, int width, int height, mode_t mode) {
+    size_t frame_len = (led_count * 3 + 63) / 64 * 64;
+    size_t len = frames_offset() + 2 * frame_len;
+
+    memset(shm, 0, sizeof(*shm));
+    shm->fd = shm_open(name, O_RDWR | O_CLOEXEC, 0);
+    if (shm->fd >= 0) {
+        if (reuse_shm(shm, frame_len, led_count, width, height, mode) == 0) return 0;
+
+        // Some other shape or owner: resizing it under a client's mapping
+        // would SIGBUS it. The client keeps the old object; the name gets a
+        // new one.
+        close(shm->fd);
+        if (shm_unlink(name) < 0 && errno != ENOENT) return -1;
+    }
+
+    shm->fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+    if (shm->fd < 0) return -1;
+
+    // A new object reads as zeros, which is most of the header
+    if (ftruncate(shm->fd, (off_t)len) < 0 || map_shm(shm, len) < 0) {
+        int err = errno;
+        close(shm->fd);
+        shm_unlink(name);
+        errno = err;
+        return -1;
+    }
+
+    struct ws2812_shm_header *h = shm->hdr;
+    h->version = WS2812_SHM_VERSION;
+    h->led_count = (uint32_t)led_count;
+    h->width = (uint32_t)width;
+    h->height = (uint32_t)height;
+    h->frame_offset[0] = (uint32_t)frames_offset();
+    h->frame_offset[1] = (uint32_t)(frames_offset() + frame_len);
+    atomic_store(&h->reading, WS2812_SHM_NONE);
+    shm->frame[0] = (uint8_t *)h + h->frame_offset[0];
+    shm->frame[1] = (uint8_t *)h + h->frame_offset[1];
+    shm->last_seq = 0;
+
+    // Clients check the magic last: everything above is valid once it is set
+    atomic_thread_fence(memory_order_release);
+    h->magic = WS2812_SHM_MAGIC;
+    return 0;
+}
+
+int ws2812_shm_attach(struct ws2812_shm *shm, const char *name) {
+    struct stat st;
+
+    memset(shm, 0, sizeof(*shm));
+    shm->fd = shm_open(name, O_RDWR | O_CLOEXEC, 0);
+    if (shm->fd < 0) return -1;
+
+    if (flock(shm->fd, LOCK_EX | LOCK_NB) < 0) {
+        if (errno == EWOULDBLOCK) errno = EBUSY;
+        goto fail;
+    }
+    if (fstat(shm->fd, &st) < 0 || map_shm(shm, (size_t)st.st_size) < 0) goto fail;
+
+    struct ws2812_shm_header *h = shm->hdr;
+    if (shm->map_len < frames_offset() || h->magic != WS2812_SHM_MAGIC || h->version != WS2812_SHM_VERSION ||
+        h->frame_offset[1] + (size_t)h->led_count * 3 > shm->map_len) {
+        munmap(shm->hdr, shm->map_len);
+        errno = EPROTO;
+        goto fail;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    shm->frame[0] = (uint8_t *)h + h->frame_offset[0];
+    shm->frame[1] = (uint8_t *)h + h->frame_offset[1];
+    shm->back = WS2812_SHM_NONE;
+    return 0;
+
+fail:;
+    int err = errno;
+    close(shm->fd);
+    errno = err;
+    return -1;
+}
+
+uint8_t *ws2812_shm_begin(struct ws2812_shm *shm) {
+    struct ws2812_shm_header *h = shm->hdr;
+
+    if (shm->back != WS2812_SHM_NONE) return shm->frame[shm->back];
+
+    uint32_t front = atomic_load(&h->front);
+    uint32_t back = front ^ 1;
+
+    // The daemon marks the frame it reads, then checks it is still the front
+    // one; we flipped 'front' before getting here, so one of us sees the other
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (atomic_load(&h->reading) == back) {
+        atomic_store(&h->client_waiting, 1);
+        if (atomic_load(&h->reading) == back) futex_wait(&h->reading, back, 10);
+        atomic_store(&h->client_waiting, 0);
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if ((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000 >= CLIENT_WAIT_MS) break;
+    }
+
+    // Carry the picture over, as the pipeline does
+    memcpy(shm->frame[back], shm->frame[front], (size_t)h->led_count * 3);
+    shm->back = back;
+    return shm->frame[back];
+}
+
+void ws2812_shm_publish(struct ws2812_shm *shm) {
+    struct ws2812_shm_header *h = shm->hdr;
+
+    if (shm->back == WS2812_SHM_NONE) return;
+    atomic_store(&h->front, shm->back);
+    atomic_fetch_add(&h->seq, 1);
+    atomic_fetch_add_explicit(&h->published, 1, memory_order_relaxed);
+    shm->back = WS2812_SHM_NONE;
+
+    if (atomic_load(&h->daemon_waiting)) futex_wake(&h->seq);
+}
+
+const uint8_t *ws2812_shm_acquire(struct ws2812_shm *shm, int timeout_ms) {
+    struct ws2812_shm_header *h = shm->hdr;
+
+    uint32_t seq = atomic_load(&h->seq);
+    if (seq == shm->last_seq) {
+        atomic_store(&h->daemon_waiting, 1);
+        futex_wait(&h->seq, seq, timeout_ms);
+        atomic_store(&h->daemon_waiting, 0);
+        seq = atomic_load(&h->seq);
+        if (seq == shm->last_seq) return NULL;
+    }
+
+    // Claim the front frame; if a client flipped it meanwhile, claim again
+    uint32_t front;
+    do {
+        front = atomic_load(&h->front);
+        atomic_store(&h->reading, front);
+    } while (atomic_load(&h->front) != front);
+
+    shm->last_seq = seq;
+    atomic_fetch_add_explicit(&h->shown, 1, memory_order_relaxed);
+    return shm->frame[front];
+}
+
+void ws2812_shm_release(struct ws2812_shm *shm) {
+    struct ws2812_shm_header *h = shm->hdr;
+
+    atomic_store(&h->reading, WS2812_SHM_NONE);
+    if (atomic_load(&h->client_waiting)) futex_wake(&h->reading);
+}
+
+void ws2812_shm_set_correction(struct ws2812_shm *shm, const struct ws2812_correction *c) {
+    struct ws2812_shm_header *h = shm->hdr;
+
+    atomic_fetch_add(&h->correction_seq, 1);
+    h->correction_on = c != NULL;
+    if (c != NULL) h->correction = *c;
+    atomic_fetch_add(&h->correction_seq, 1);
+}
+
+int ws2812_shm_get_correction(struct ws2812_shm *shm, struct ws2812_correction *c, int *on) {
+    struct ws2812_shm_header *h = shm->hdr;
+
+    uint32_t seq = atomic_load(&h->correction_seq);
+    if (seq == shm->last_correction || (seq & 1)) return 0;
+
+    struct ws2812_correction copy = h->correction;
+    int copy_on = h->correction_on;
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load(&h->correction_seq) != seq) return 0;   // torn: try next frame
+
+    shm->last_correction = seq;
+    *c = copy;
+    *on = copy_on;
+    return 1;
+}
+
+void ws2812_shm_close(struct ws2812_shm *shm) {
+    if (shm->hdr != NULL) munmap(shm->hdr, shm->map_len);
+    if (shm->fd >= 0) close(shm->fd);
+    shm->hdr = NULL;
+    shm->fd = -1;
+}
@@ -0,0 +1,97 @@
+#ifndef WS2812_SHM_H
+#define WS2812_SHM_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "ws2812_correct.h"
+
+// Shared-memory framebuffer between the LED daemon (ws2812d), which owns the
+// SPI device, and the pattern program drawing on it.
+//
+// The POSIX shm object holds this header and two G-R-B frames. The client
+// draws straight into the back frame and publishes it by flipping 'front'
+// and bumping 'seq'; the daemon encodes from the shared frame itself. Both
+// sides only make a futex syscall when the other is actually asleep, so a
+// frame costs no copies and, normally, one wake-up.
+//
+// Programs use it through the device path: WS2812_DEVICE=shm:/ws2812.
+#define WS2812_SHM_DEFAULT "/ws2812"
+#define WS2812_SHM_MODE 0660            // owner and group draw; others nothing
+#define WS2812_SHM_MAGIC 0x32313857u    // "W812"
+#define WS2812_SHM_VERSION 1
+#define WS2812_SHM_NONE 2u              // 'reading' when the daemon reads neither frame
+
+struct ws2812_shm_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t led_count;         // LEDs per frame
+    uint32_t width;             // canvas the daemon's layout describes
+    uint32_t height;
+    uint32_t frame_offset[2];   // from the start of the mapping
+
+    _Atomic uint32_t front;     // frame holding the newest picture
+    _Atomic uint32_t seq;       // bumped per published frame (daemon sleeps on it)
+    _Atomic uint32_t reading;   // frame the daemon is encoding (client sleeps on it)
+    _Atomic uint32_t daemon_waiting;
+    _Atomic uint32_t client_waiting;
+
+    _Atomic uint64_t published; // frames published by clients
+    _Atomic uint64_t shown;     // frames the daemon has taken
+
+    // The client's color correction, applied by the daemon. Written under a
+    // sequence count: odd while being written, bumped again when done.
+    _Atomic uint32_t correction_seq;
+    uint32_t correction_on;
+    struct ws2812_correction correction;
+};
+
+struct ws2812_shm {
+    struct ws2812_shm_header *hdr;
+    size_t map_len;
+    int fd;
+    uint8_t *frame[2];
+    uint32_t back;              // client: frame being drawn
+    uint32_t last_seq;          // daemon: last frame taken
+    uint32_t last_correction;   // daemon: correction_seq last applied
+};
+
+// Daemon: create the shm object for led_count LEDs. One a previous daemon
+// left behind is taken over untouched if it has the same LED count and
+// canvas, so an attached client carries on; otherwise it is unlinked and a
+// new one created, and the client must attach again to be seen.
+// A new object gets mode less the umask; anyone it lets write can change
+// every pixel and the header, so keep it to the pattern users' group. One
+// left behind is replaced if it is not ours or is open to more than mode.
+// Returns 0, or -1 with errno set.
+int ws2812_shm_create(struct ws2812_shm *shm, const char *name, size_t led_count, int width, int height, mode_t mode);
+
+// Client: map an existing shm object. Only one client may draw at a time:
+// fails with EBUSY while another holds it. Returns 0, or -1 with errno set.
+int ws2812_shm_attach(struct ws2812_shm *shm, const char *name);
+
+// Client: the frame to draw into next, holding the last published picture.
+// Waits only if the daemon is still encoding from it.
+uint8_t *ws2812_shm_begin(struct ws2812_shm *shm);
+
+// Client: show the frame from ws2812_shm_begin().
+void ws2812_shm_publish(struct ws2812_shm *shm);
+
+// Daemon: wait up to timeout_ms for a new frame (-1 = forever). Returns it,
+// or NULL on timeout. The frame stays the client's again after
+// ws2812_shm_release().
+const uint8_t *ws2812_shm_acquire(struct ws2812_shm *shm, int timeout_ms);
+void ws2812_shm_release(struct ws2812_shm *shm);
+
+// Client: hand the daemon a correction to apply (NULL = none).
+void ws2812_shm_set_correction(struct ws2812_shm *shm, const struct ws2812_correction *c);
+
+// Daemon: if the client's correction changed since the last call, copy it
+// to *c and return 1 (*on says whether it is on); otherwise return 0.
+int ws2812_shm_get_correction(struct ws2812_shm *shm, struct ws2812_correction *c, int *on);
+
+void ws2812_shm_close(struct ws2812_shm *shm);
+
+#endif
@@ -0,0 +1,132 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+
+#include "ws2812_spi.h"
+
+static size_t read_bufsiz(void) {
+    FILE *f = fopen("/sys/module/spidev/parameters/bufsiz", "r");
+    unsigned long bufsiz = 0;
+
+    if (f != NULL) {
+        if (fscanf(f, "%lu", &bufsiz) != 1) bufsiz = 0;
+        fclose(f);
+    }
+    return bufsiz ? bufsiz : WS2812_SPI_DEFAULT_BUFSIZ;
+}
+
+int ws2812_spi_open(struct ws2812_spi *s, const char *path) {
+    memset(s, 0, sizeof(*s));
+    s->fd = -1;
+    s->max_transfers = WS2812_SPI_MAX_TRANSFERS;
+
+    if (strcmp(path, "mock:") == 0) {
+        s->max_message = WS2812_SPI_DEFAULT_BUFSIZ;
+    } else {
+        s->fd = open(path, O_RDWR | O_CLOEXEC);
+        if (s->fd < 0) return -1;
+        s->max_message = read_bufsiz();
+    }
+
+    s->queue = calloc(s->max_transfers, sizeof(*s->queue));
+    if (s->queue == NULL) {
+        ws2812_spi_close(s);
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+int ws2812_spi_add(struct ws2812_spi *s, const struct ws2812_spi_xfer *x) {
+    size_t cost = ws2812_spi_aligned(x->len);
+    if (cost > s->max_message) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    if (s->queued == s->max_transfers || (x->tx && s->tx_bytes + cost > s->max_message) ||
+        (x->rx && s->rx_bytes + cost > s->max_message)) {
+        if (ws2812_spi_flush(s) < 0) return -1;
+    }
+
+    struct spi_ioc_transfer *tr = &s->queue[s->queued++];
+    memset(tr, 0, sizeof(*tr));
+    tr->tx_buf = (unsigned long)x->tx;
+    tr->rx_buf = (unsigned long)x->rx;
+    tr->len = x->len;
+    tr->speed_hz = x->speed_hz;
+    tr->delay_usecs = x->delay_usecs;
+    tr->bits_per_word = x->bits_per_word;
+    tr->cs_change = x->cs_change;
+    if (x->tx) s->tx_bytes += cost;
+    if (x->rx) s->rx_bytes += cost;
+    return 0;
+}
+
+// spidev packs words of 9-16 bits in 2 bytes and 17-32 in 4, little
+// endian; only the low bits_per_word of each reach the wire
+static size_t word_bytes(unsigned bits) {
+    return bits <= 8 ? 1 : bits <= 16 ? 2 : 4;
+}
+
+// mock: every transfer reads back what it sent, as with MOSI tied to MISO
+static int mock_message(const struct spi_ioc_transfer *tr, unsigned n) {
+    for (unsigned i = 0; i < n; i++) {
+        const uint8_t *tx = (const uint8_t *)(uintptr_t)tr[i].tx_buf;
+        uint8_t *rx = (uint8_t *)(uintptr_t)tr[i].rx_buf;
+        unsigned bits = tr[i].bits_per_word ? tr[i].bits_per_word : 8;
+        size_t w = word_bytes(bits);
+        if (bits > 32 || tr[i].len % w != 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        if (rx == NULL) continue;
+        if (tx == NULL) {
+            memset(rx, 0, tr[i].len);
+        } else if (bits % 8 == 0) {
+            memcpy(rx, tx, tr[i].len);
+        } else {
+            for (size_t b = 0; b < tr[i].len; b++) {
+                int left = (int)bits - (int)(b % w) * 8;
+                rx[b] = tx[b] & (left >= 8 ? 0xFF : left <= 0 ? 0 : (1u << left) - 1);
+            }
+        }
+    }
+    return 0;
+}
+
+int ws2812_spi_flush(struct ws2812_spi *s) {
+    unsigned n = s->queued;
+    if (n == 0) return 0;
+    s->queued = 0;
+    s->tx_bytes = s->rx_bytes = 0;
+
+    // The message's end deselects anyway; cs_change on the last transfer
+    // would instead tell the controller to keep the device selected
+    s->queue[n - 1].cs_change = 0;
+
+    int ret = s->fd < 0 ? mock_message(s->queue, n) : ioctl(s->fd, SPI_IOC_MESSAGE(n), s->queue);
+    if (ret < 0) return -1;
+    s->messages++;
+    s->transfers += n;
+    return 0;
+}
+
+int ws2812_spi_transfer(struct ws2812_spi *s, const struct ws2812_spi_xfer *x, unsigned n) {
+    for (unsigned i = 0; i < n; i++) {
+        if (ws2812_spi_add(s, &x[i]) < 0) return -1;
+    }
+    return ws2812_spi_flush(s);
+}
+
+void ws2812_spi_close(struct ws2812_spi *s) {
+    if (s->fd >= 0) close(s->fd);
+    s->fd = -1;
+    free(s->queue);
+    s->queue = NULL;
+    s->queued = 0;
+}
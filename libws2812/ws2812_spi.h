@@ -0,0 +1,80 @@
+#ifndef WS2812_SPI_H
+#define WS2812_SPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Batched spidev transfers. Transfers are queued and go out together as one
+// SPI_IOC_MESSAGE(n) - one syscall and one controller setup for the lot -
+// instead of an ioctl each. The WS2812 transport sends its frame chunks this
+// way, and so does anything chatty on the bus ( a MAX7219 cascade takes a
+// chip-select pulse per register write, eight writes a frame ).
+//
+// A message is bounded by the kernel twice: at most WS2812_SPI_MAX_TRANSFERS
+// transfers fit the ioctl, and spidev copies the message into a bounce
+// buffer of 'bufsiz' bytes each way ( a module parameter, 4096 unless
+// raised ), counting every transfer rounded up to WS2812_SPI_ALIGN. Adding a
+// transfer that would cross either limit sends what is queued first, so a
+// batch of any length goes out in as few messages as fit.
+//
+// Chip select drops between those messages, as at the end of any message.
+// Transfers that must share one select ( a WS2812 frame ) must fit in one:
+// flush, then queue no more than a message holds.
+//
+// The path "mock:" is an in-memory loopback - every transfer reads back what
+// it sent - with spidev's limits, for benchmarks and running off the board.
+
+#define WS2812_SPI_DEFAULT_BUFSIZ 4096
+#define WS2812_SPI_MAX_TRANSFERS 511    // SPI_IOC_MESSAGE(n)'s 14-bit size field
+#define WS2812_SPI_ALIGN 64             // spidev's per-transfer rounding ( kmalloc alignment )
+
+struct spi_ioc_transfer;
+
+// What a transfer of len bytes counts against bufsiz
+static inline size_t ws2812_spi_aligned(size_t len) {
+    return (len + WS2812_SPI_ALIGN - 1) / WS2812_SPI_ALIGN * WS2812_SPI_ALIGN;
+}
+
+// One transfer. Fields left 0 take the device's settings.
+struct ws2812_spi_xfer {
+    const void *tx;             // NULL shifts out zeros
+    void *rx;                   // NULL throws the input away
+    uint32_t len;               // bytes; words over 8 bits take 2 or 4 each
+    uint32_t speed_hz;
+    uint16_t delay_usecs;       // pause after the transfer
+    uint8_t bits_per_word;
+    uint8_t cs_change;          // deselect the device after this transfer
+};
+
+struct ws2812_spi {
+    int fd;                     // spidev, -1 for mock:
+    size_t max_message;         // spidev bufsiz
+    unsigned max_transfers;
+
+    // Queued, not yet sent. tx and rx must stay valid until they are.
+    struct spi_ioc_transfer *queue;
+    unsigned queued;
+    size_t tx_bytes, rx_bytes;  // as spidev counts them against bufsiz
+
+    uint64_t messages, transfers;   // sent so far
+};
+
+// Open a spidev node, or "mock:". Returns 0, or -1 with errno set.
+int ws2812_spi_open(struct ws2812_spi *s, const char *path);
+
+// Queue one transfer, first sending the queue if it would not fit in the
+// same message. The buffers are not copied. Returns 0, or -1 with errno set
+// (EMSGSIZE if the transfer alone is more than a message can carry, or
+// whatever sending the queue failed with).
+int ws2812_spi_add(struct ws2812_spi *s, const struct ws2812_spi_xfer *x);
+
+// Send what is queued as one message. The queue is empty afterwards, sent
+// or not. Returns 0, or -1 with errno set.
+int ws2812_spi_flush(struct ws2812_spi *s);
+
+// Queue n transfers and send them. Returns 0, or -1 with errno set.
+int ws2812_spi_transfer(struct ws2812_spi *s, const struct ws2812_spi_xfer *x, unsigned n);
+
+void ws2812_spi_close(struct ws2812_spi *s);
+
+#endif
@@ -0,0 +1,119 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ws2812_sprite.h"
+
+int ws2812_sprite_from_bits(struct ws2812_sprite *s, const uint8_t *bits, int width, int height) {
+    memset(s, 0, sizeof(*s));
+    if (width <= 0 || height <= 0 || width > UINT16_MAX || height > UINT16_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    size_t stride = ((size_t)width + 7) / 8;
+    size_t lit = 0;
+    for (size_t i = 0; i < stride * height; i++) lit += __builtin_popcount(bits[i]);
+
+    s->width = width;
+    s->height = height;
+    s->x = malloc((lit ? lit : 1) * sizeof(*s->x));
+    s->y = malloc((lit ? lit : 1) * sizeof(*s->y));
+    s->grb = calloc(lit ? lit : 1, 3);
+    if (s->x == NULL || s->y == NULL || s->grb == NULL) {
+        ws2812_sprite_free(s);
+        return -1;
+    }
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t *row = bits + y * stride;
+        for (int x = 0; x < width; x++) {
+            if (row[x >> 3] & (0x80 >> (x & 7))) {
+                s->x[s->count] = (uint16_t)x;
+                s->y[s->count] = (uint16_t)y;
+                s->count++;
+            }
+        }
+    }
+    return 0;
+}
+
+void ws2812_sprite_fill(struct ws2812_sprite *s, uint8_t r, uint8_t g, uint8_t b) {
+    for (size_t i = 0; i < s->count; i++) {
+        s->grb[i * 3]     = g;
+        s->grb[i * 3 + 1] = r;
+        s->grb[i * 3 + 2] = b;
+    }
+}
+
+void ws2812_sprite_free(struct ws2812_sprite *s) {
+    free(s->x);
+    free(s->y);
+    free(s->grb);
+    memset(s, 0, sizeof(*s));
+}
+
+// alpha 0..255 as a weight of 0..256, so both ends are exact
+static inline uint8_t mix(uint8_t dst, uint8_t src, unsigned w) {
+    return (uint8_t)((src * w + dst * (256 - w)) >> 8);
+}
+
+static inline uint8_t add(uint8_t dst, uint8_t src) {
+    unsigned v = dst + src;
+    return v > 255 ? 255 : (uint8_t)v;
+}
+
+static inline uint8_t max8(uint8_t dst, uint8_t src) {
+    return src > dst ? src : dst;
+}
+
+// The mode is the same for a whole layer, so this branch always predicts
+static inline void blend_pixel(uint8_t *dst, const uint8_t *src, enum ws2812_blend mode, unsigned w) {
+    switch (mode) {
+        case WS2812_BLEND_ADD:
+            dst[0] = add(dst[0], src[0]);
+            dst[1] = add(dst[1], src[1]);
+            dst[2] = add(dst[2], src[2]);
+            break;
+        case WS2812_BLEND_MAX:
+            dst[0] = max8(dst[0], src[0]);
+            dst[1] = max8(dst[1], src[1]);
+            dst[2] = max8(dst[2], src[2]);
+            break;
+        case WS2812_BLEND_ALPHA:
+            dst[0] = mix(dst[0], src[0], w);
+            dst[1] = mix(dst[1], src[1], w);
+            dst[2] = mix(dst[2], src[2], w);
+            break;
+        default:
+            memcpy(dst, src, 3);
+            break;
+    }
+}
+
+void ws2812_sprite_draw(struct ws2812 *dev, const struct ws2812_layout *l, const struct ws2812_sprite *s,
+                        int x, int y, enum ws2812_blend mode, uint8_t alpha) {
+    unsigned w = alpha + (alpha >> 7);
+
+    for (size_t i = 0; i < s->count; i++) {
+        size_t led = ws2812_layout_index(l, x + s->x[i], y + s->y[i]);
+        if (led >= dev->led_count) continue;
+        blend_pixel(dev->pixels + led * 3, s->grb + i * 3, mode, w);
+    }
+}
+
+void ws2812_draw_list(struct ws2812 *dev, const uint32_t *leds, const uint8_t *grb, size_t count,
+                      enum ws2812_blend mode, uint8_t alpha) {
+    unsigned w = alpha + (alpha >> 7);
+
+    for (size_t i = 0; i < count; i++) {
+        if (leds[i] >= dev->led_count) continue;
+        blend_pixel(dev->pixels + (size_t)leds[i] * 3, grb + i * 3, mode, w);
+    }
+}
+
+void ws2812_clear_list(struct ws2812 *dev, const uint32_t *leds, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (leds[i] < dev->led_count) memset(dev->pixels + (size_t)leds[i] * 3, 0, 3);
+    }
+}
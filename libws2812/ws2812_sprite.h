@@ -0,0 +1,54 @@
+#ifndef WS2812_SPRITE_H
+#define WS2812_SPRITE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ws2812.h"
+
+// Sprites and blending.
+// A sprite keeps only its lit pixels, as a list, so drawing it touches those
+// LEDs and nothing else in the frame however big the canvas is. Layers are
+// drawn one after the other, each with its own blend mode.
+
+enum ws2812_blend {
+    WS2812_BLEND_COPY,      // replace what is there
+    WS2812_BLEND_ADD,       // add, clamped at 255
+    WS2812_BLEND_MAX,       // brighter of the two, per channel
+    WS2812_BLEND_ALPHA,     // mix by alpha: 255 = sprite only, 0 = unchanged
+};
+
+struct ws2812_sprite {
+    int width;              // bounding box
+    int height;
+    size_t count;           // lit pixels
+    uint16_t *x;            // position of each lit pixel in the box
+    uint16_t *y;
+    uint8_t *grb;           // color of each lit pixel, G-R-B order
+};
+
+// Build a sprite from a packed 1-bit bitmap: one row after the other, each
+// padded to whole bytes, leftmost pixel in the top bit. Lit pixels start
+// out black. Returns 0, or -1 with errno set.
+int ws2812_sprite_from_bits(struct ws2812_sprite *s, const uint8_t *bits, int width, int height);
+
+// Give every lit pixel the same color
+void ws2812_sprite_fill(struct ws2812_sprite *s, uint8_t r, uint8_t g, uint8_t b);
+
+void ws2812_sprite_free(struct ws2812_sprite *s);
+
+// Blend the sprite into the frame with its top left corner at canvas x, y.
+// Pixels that fall off the canvas are skipped. alpha is only used by
+// WS2812_BLEND_ALPHA.
+void ws2812_sprite_draw(struct ws2812 *dev, const struct ws2812_layout *l, const struct ws2812_sprite *s,
+                        int x, int y, enum ws2812_blend mode, uint8_t alpha);
+
+// Sparse form: blend count G-R-B colors onto the LEDs at the given chain
+// indexes (e.g. from ws2812_map_chain()). Out of range indexes are skipped.
+void ws2812_draw_list(struct ws2812 *dev, const uint32_t *leds, const uint8_t *grb, size_t count,
+                      enum ws2812_blend mode, uint8_t alpha);
+
+// Turn count LEDs at the given chain indexes off
+void ws2812_clear_list(struct ws2812 *dev, const uint32_t *leds, size_t count);
+
+#endif
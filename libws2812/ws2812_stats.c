@@ -0,0 +1,147 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ws2812.h"
+
+static const char *const stage_names[WS2812_STAGE_COUNT] = {
+    [WS2812_STAGE_RENDER] = "render",
+    [WS2812_STAGE_ENCODE] = "encode",
+    [WS2812_STAGE_SEND]   = "send",
+    [WS2812_STAGE_FRAME]  = "frame",
+    [WS2812_STAGE_WAKE]   = "wake",
+};
+
+struct ws2812_stats *ws2812_stats_create(const char *path, size_t led_count) {
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return NULL;
+
+    size_t len = sizeof(struct ws2812_stats);
+    struct ws2812_stats *s = MAP_FAILED;
+    if (ftruncate(fd, (off_t)len) == 0) {
+        s = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    int err = errno;
+    close(fd);
+    if (s == MAP_FAILED) {
+        errno = err;
+        return NULL;
+    }
+
+    // A reader seeing the old magic of a reused file gets zeroes, not garbage
+    memset(s, 0, len);
+    s->version = WS2812_STATS_VERSION;
+    s->pid = (int32_t)getpid();
+    s->led_count = (uint32_t)led_count;
+    atomic_thread_fence(memory_order_release);
+    s->magic = WS2812_STATS_MAGIC;
+    return s;
+}
+
+const struct ws2812_stats *ws2812_stats_attach(const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+
+    size_t len = sizeof(struct ws2812_stats);
+    struct stat st;
+    const struct ws2812_stats *s = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size == len) {
+        s = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    } else {
+        errno = EINVAL;
+    }
+    int err = errno;
+    close(fd);
+    if (s == MAP_FAILED) {
+        errno = err;
+        return NULL;
+    }
+
+    if (s->magic != WS2812_STATS_MAGIC || s->version != WS2812_STATS_VERSION) {
+        munmap((void *)s, len);
+        errno = EINVAL;
+        return NULL;
+    }
+    return s;
+}
+
+void ws2812_stats_close(const struct ws2812_stats *s) {
+    if (s != NULL) munmap((void *)s, sizeof(*s));
+}
+
+void ws2812_stats_from_env(struct ws2812 *dev) {
+    const char *path = getenv("WS2812_STATS");
+    if (path == NULL || *path == '\0' || dev->stats != NULL) return;
+
+    dev->stats = ws2812_stats_create(path, dev->led_count);
+    if (dev->stats == NULL) {
+        fprintf(stderr, "Can't write stats to %s: %s\n", path, strerror(errno));
+    }
+}
+
+uint64_t ws2812_stats_bucket_limit(unsigned b) {
+    if (b < WS2812_STATS_LINEAR) return (uint64_t)(b + 1) * 1000;
+
+    unsigned e = (b - WS2812_STATS_LINEAR) / 8 + 4;
+    uint64_t step = 1ull << (e - 3);
+    return ((8 + (b - WS2812_STATS_LINEAR) % 8) * step + step) * 1000;
+}
+
+static uint64_t bucket_start(unsigned b) {
+    return b == 0 ? 0 : ws2812_stats_bucket_limit(b - 1);
+}
+
+void ws2812_stats_snapshot(const struct ws2812_stats *s, enum ws2812_stage stage, struct ws2812_stage_snapshot *out) {
+    const struct ws2812_stage_stats *st = &s->stage[stage];
+
+    out->count = atomic_load_explicit(&st->count, memory_order_relaxed);
+    out->total_ns = atomic_load_explicit(&st->total_ns, memory_order_relaxed);
+    out->max_ns = atomic_load_explicit(&st->max_ns, memory_order_relaxed);
+    for (unsigned b = 0; b < WS2812_STATS_BUCKETS; b++) {
+        out->hist[b] = (uint32_t)atomic_load_explicit(&st->hist[b], memory_order_relaxed);
+    }
+}
+
+void ws2812_stats_diff(struct ws2812_stage_snapshot *out, const struct ws2812_stage_snapshot *now,
+                       const struct ws2812_stage_snapshot *before) {
+    out->count = now->count - before->count;
+    out->total_ns = now->total_ns - before->total_ns;
+    out->max_ns = now->max_ns;
+    for (unsigned b = 0; b < WS2812_STATS_BUCKETS; b++) {
+        out->hist[b] = now->hist[b] - before->hist[b];
+    }
+}
+
+uint64_t ws2812_stats_percentile(const struct ws2812_stage_snapshot *snap, double p) {
+    // The histogram is read bucket by bucket while it is being written, so
+    // sum it rather than trusting count
+    uint64_t total = 0;
+    for (unsigned b = 0; b < WS2812_STATS_BUCKETS; b++) total += snap->hist[b];
+    if (total == 0) return 0;
+
+    uint64_t rank = (uint64_t)(p / 100.0 * (double)total + 0.5);
+    if (rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < WS2812_STATS_BUCKETS; b++) {
+        if (seen + snap->hist[b] >= rank) {
+            // Spread the bucket's samples evenly over its width
+            uint64_t start = bucket_start(b);
+            uint64_t width = ws2812_stats_bucket_limit(b) - start;
+            uint64_t v = start + width * (rank - seen) / snap->hist[b];
+            // Nothing took longer than max
+            return snap->max_ns != 0 && snap->max_ns < v ? snap->max_ns : v;
+        }
+        seen += snap->hist[b];
+    }
+    return ws2812_stats_bucket_limit(WS2812_STATS_BUCKETS - 1);
+}
+
+const char *ws2812_stage_name(enum ws2812_stage stage) {
+    return stage < WS2812_STAGE_COUNT ? stage_names[stage] : "?";
+}
@@ -0,0 +1,120 @@
+#ifndef WS2812_STATS_H
+#define WS2812_STATS_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// Frame timing, kept in a file other processes can map.
+//
+// With WS2812_STATS=/run/ws2812/<name>.stats a program maps that file and
+// every frame adds its stage times to per-stage histograms there: a couple
+// of clock_gettime() calls and relaxed atomic adds per stage, no syscalls,
+// no locks. build/ws2812_stat reads the same file, live or after the
+// program has gone, and prints p50/p99/max per stage.
+
+#define WS2812_STATS_MAGIC   0x54535857u     // "WXST"
+#define WS2812_STATS_VERSION 1
+
+// Log-linear histogram over microseconds: exact below 16 us, then 8 buckets
+// per power of two (12.5% wide) up to about two minutes
+#define WS2812_STATS_LINEAR  16
+#define WS2812_STATS_BUCKETS 208
+
+enum ws2812_stage {
+    WS2812_STAGE_RENDER,    // pattern drawing, pipeline begin() to submit()
+    WS2812_STAGE_ENCODE,    // correction + SPI encoding of the changed LEDs
+    WS2812_STAGE_SEND,      // the SPI ioctl (or its mock / shm / multi-bus stand-in)
+    WS2812_STAGE_FRAME,     // submit() to submit(): the frame period actually achieved
+    WS2812_STAGE_WAKE,      // how far past its deadline each frame started
+    WS2812_STAGE_COUNT
+};
+
+struct ws2812_stage_stats {
+    atomic_uint_fast64_t count;
+    atomic_uint_fast64_t total_ns;
+    atomic_uint_fast64_t max_ns;
+    _Atomic uint32_t hist[WS2812_STATS_BUCKETS];
+};
+
+struct ws2812_stats {
+    uint32_t magic;         // written last, once the rest is ready
+    uint32_t version;
+    int32_t pid;
+    uint32_t led_count;
+
+    atomic_uint_fast64_t errors;    // failed sends (ioctl returned < 0)
+    atomic_int last_error;          // errno of the latest one
+    atomic_uint_fast64_t missed;    // frame clock deadlines missed
+    atomic_uint_fast64_t skipped;   // unchanged frames not sent
+
+    struct ws2812_stage_stats stage[WS2812_STAGE_COUNT];
+};
+
+// A plain copy of one stage, for working out percentiles
+struct ws2812_stage_snapshot {
+    uint64_t count, total_ns, max_ns;
+    uint32_t hist[WS2812_STATS_BUCKETS];
+};
+
+struct ws2812;
+
+// Create (or reset) the stats file at path and map it. Returns NULL with
+// errno set on failure.
+struct ws2812_stats *ws2812_stats_create(const char *path, size_t led_count);
+
+// Map an existing stats file read-only. Returns NULL with errno set
+// (EINVAL if it is not a stats file of this version).
+const struct ws2812_stats *ws2812_stats_attach(const char *path);
+
+void ws2812_stats_close(const struct ws2812_stats *s);
+
+// Record into the file named by WS2812_STATS, if set. The device owns the
+// mapping from then on and ws2812_close() releases it. Failures are reported
+// on stderr and otherwise ignored.
+void ws2812_stats_from_env(struct ws2812 *dev);
+
+static inline uint64_t ws2812_stats_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+static inline unsigned ws2812_stats_bucket(uint64_t ns) {
+    uint64_t us = ns / 1000;
+    if (us < WS2812_STATS_LINEAR) return (unsigned)us;
+
+    unsigned e = 63 - __builtin_clzll(us);  // >= 4
+    unsigned b = WS2812_STATS_LINEAR + (e - 4) * 8 + ((us >> (e - 3)) & 7);
+    return b < WS2812_STATS_BUCKETS ? b : WS2812_STATS_BUCKETS - 1;
+}
+
+// One sample of ns nanoseconds. Each stage has one writing thread, so max
+// needs no compare-and-swap.
+static inline void ws2812_stats_record(struct ws2812_stats *s, enum ws2812_stage stage, uint64_t ns) {
+    struct ws2812_stage_stats *st = &s->stage[stage];
+
+    atomic_fetch_add_explicit(&st->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&st->total_ns, ns, memory_order_relaxed);
+    atomic_fetch_add_explicit(&st->hist[ws2812_stats_bucket(ns)], 1, memory_order_relaxed);
+    if (ns > atomic_load_explicit(&st->max_ns, memory_order_relaxed)) {
+        atomic_store_explicit(&st->max_ns, ns, memory_order_relaxed);
+    }
+}
+
+// Upper edge of bucket b, in nanoseconds
+uint64_t ws2812_stats_bucket_limit(unsigned b);
+
+void ws2812_stats_snapshot(const struct ws2812_stats *s, enum ws2812_stage stage, struct ws2812_stage_snapshot *out);
+
+// now - before, for the samples taken between two snapshots (max stays now's)
+void ws2812_stats_diff(struct ws2812_stage_snapshot *out, const struct ws2812_stage_snapshot *now,
+                       const struct ws2812_stage_snapshot *before);
+
+// The p-th percentile (0-100), interpolated within its bucket, 0 if empty
+uint64_t ws2812_stats_percentile(const struct ws2812_stage_snapshot *snap, double p);
+
+const char *ws2812_stage_name(enum ws2812_stage stage);
+
+#endif
@@ -0,0 +1,181 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ws2812_transport.h"
+
+// --- spidev ---
+
+static int spidev_send(struct ws2812_transport *t, const uint8_t *buf, size_t len) {
+    // spidev charges every chunk rounded up to WS2812_SPI_ALIGN. The chunks
+    // before the last are multiples of it, so the frame costs len rounded
+    // up; more than bufsiz and the batch would send the tail as a second
+    // message, latching the chain mid-frame
+    size_t cost = ws2812_spi_aligned(len);
+    if (cost > t->spi.max_message || len > t->chunk_bytes * WS2812_SPI_MAX_CHUNKS) {
+        static int warned;
+        if (!warned) {
+            fprintf(stderr, "Frame is %zu SPI bytes but spidev bufsiz is %zu: "
+                    "raise it with spidev.bufsiz=%zu on the kernel command line\n",
+                    len, t->spi.max_message, cost);
+            warned = 1;
+        }
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    // The queue is empty between frames, so the whole frame is one message
+    struct ws2812_spi_xfer x = { .speed_hz = t->speed_hz, .bits_per_word = 8 };
+    for (size_t off = 0; off < len; off += t->chunk_bytes) {
+        x.tx = buf + off;
+        x.len = (uint32_t)(len - off < t->chunk_bytes ? len - off : t->chunk_bytes);
+        // Latch only after the last chunk
+        if (off + x.len == len) x.delay_usecs = t->latch_usecs;
+        if (ws2812_spi_add(&t->spi, &x) < 0) return -1;
+    }
+    return ws2812_spi_flush(&t->spi);
+}
+
+static void spidev_close(struct ws2812_transport *t) {
+    ws2812_spi_close(&t->spi);
+}
+
+static void fd_close(struct ws2812_transport *t) {
+    if (t->fd >= 0) close(t->fd);
+    t->fd = -1;
+}
+
+static const struct ws2812_transport_ops spidev_ops = {
+    .name = "spidev",
+    .send = spidev_send,
+    .close = spidev_close,
+};
+
+// --- Mock backends ---
+
+// Decode into t->decoded. Runs on the frame path, but the buffer only grows
+// when a bigger frame than ever before comes through.
+static int mock_decode(struct ws2812_transport *t, const uint8_t *buf, size_t len) {
+    size_t need = len / (size_t)t->mode + 1;
+
+    if (need > t->decoded_cap) {
+        uint8_t *p = realloc(t->decoded, need);
+        if (p == NULL) return -1;
+        t->decoded = p;
+        t->decoded_cap = need;
+    }
+
+    long n = ws2812_decode(t->mode, t->decoded, buf, len);
+    if (n < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    t->decoded_len = (size_t)n;
+    t->frames++;
+    return 0;
+}
+
+static int mem_send(struct ws2812_transport *t, const uint8_t *buf, size_t len) {
+    return mock_decode(t, buf, len);
+}
+
+static int null_send(struct ws2812_transport *t, const uint8_t *buf, size_t len) {
+    (void)buf;
+    (void)len;
+    t->frames++;
+    return 0;
+}
+
+static int file_send(struct ws2812_transport *t, const uint8_t *buf, size_t len) {
+    if (mock_decode(t, buf, len) < 0) return -1;
+
+    size_t done = 0;
+    while (done < t->decoded_len) {
+        ssize_t n = write(t->fd, t->decoded + done, t->decoded_len - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        done += (size_t)n;
+    }
+    return 0;
+}
+
+static int unix_send(struct ws2812_transport *t, const uint8_t *buf, size_t len) {
+    if (mock_decode(t, buf, len) < 0) return -1;
+
+    ssize_t n = sendto(t->fd, t->decoded, t->decoded_len, MSG_DONTWAIT,
+                       (struct sockaddr *)&t->peer, sizeof(t->peer));
+    // Nobody listening (or too slow) is not an error for a display sink
+    if (n < 0 && errno != ECONNREFUSED && errno != ENOENT && errno != EAGAIN) return -1;
+    return 0;
+}
+
+static void mock_close(struct ws2812_transport *t) {
+    fd_close(t);
+    free(t->decoded);
+    t->decoded = NULL;
+    t->decoded_cap = t->decoded_len = 0;
+}
+
+static const struct ws2812_transport_ops null_ops = { .name = "null", .send = null_send, .close = mock_close };
+static const struct ws2812_transport_ops mem_ops = { .name = "mock", .send = mem_send, .close = mock_close };
+static const struct ws2812_transport_ops file_ops = { .name = "file", .send = file_send, .close = mock_close };
+static const struct ws2812_transport_ops unix_ops = { .name = "unix", .send = unix_send, .close = mock_close };
+
+// --- Common ---
+
+int ws2812_transport_open(struct ws2812_transport *t, const char *path, enum ws2812_mode mode) {
+    memset(t, 0, sizeof(*t));
+    t->fd = -1;
+    t->mode = mode;
+    t->speed_hz = ws2812_speed_hz(mode);
+    t->latch_usecs = WS2812_LATCH_USECS;
+
+    if (strcmp(path, "null:") == 0) {
+        t->ops = &null_ops;
+    } else if (strcmp(path, "mock:") == 0) {
+        t->ops = &mem_ops;
+    } else if (strncmp(path, "file:", 5) == 0) {
+        t->ops = &file_ops;
+        t->fd = open(path + 5, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    } else if (strncmp(path, "unix:", 5) == 0) {
+        t->ops = &unix_ops;
+        if (strlen(path + 5) >= sizeof(t->peer.sun_path)) {
+            errno = ENAMETOOLONG;
+            return -1;
+        }
+        t->peer.sun_family = AF_UNIX;
+        strcpy(t->peer.sun_path, path + 5);
+        t->fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    } else {
+        t->ops = &spidev_ops;
+        if (ws2812_spi_open(&t->spi, path) < 0) return -1;
+
+        // Chunks are kept to multiples of spidev's rounding to waste nothing
+        size_t max = t->spi.max_message;
+        size_t chunk = max < WS2812_SPI_CHUNK_BYTES ? max : WS2812_SPI_CHUNK_BYTES;
+        t->chunk_bytes = chunk >= WS2812_SPI_ALIGN ? chunk / WS2812_SPI_ALIGN * WS2812_SPI_ALIGN : chunk;
+        return 0;
+    }
+
+    if (t->ops != &mem_ops && t->ops != &null_ops && t->fd < 0) return -1;
+    return 0;
+}
+
+int ws2812_transport_send(struct ws2812_transport *t, const uint8_t *buf, size_t len) {
+    return t->ops->send(t, buf, len);
+}
+
+void ws2812_transport_close(struct ws2812_transport *t) {
+    if (t->ops != NULL) t->ops->close(t);
+    t->ops = NULL;
+}
+
+const char *ws2812_device_from_env(const char *def) {
+    const char *s = getenv("WS2812_DEVICE");
+    return (s != NULL && *s != '\0') ? s : def;
+}
@@ -0,0 +1,72 @@
+#ifndef WS2812_TRANSPORT_H
+#define WS2812_TRANSPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "ws2812_encode.h"
+#include "ws2812_spi.h"
+
+// Where encoded frames go. Picked by the device path given to ws2812_open():
+//
+//   /dev/spidev0.0     the real SPI device (anything not listed below)
+//   null:              discarded (benchmarks)
+//   mock:              in memory - the last frame is decoded back to GRB
+//   file:/tmp/leds     decoded GRB frames appended to a file
+//   unix:/tmp/leds.sock  each decoded GRB frame sent as one datagram
+//
+// The mock backends decode the waveform with ws2812_decode(), so a frame
+// that is not valid WS2812 data fails the send with EINVAL, just as it
+// would look wrong on the LEDs.
+struct ws2812_transport;
+
+struct ws2812_transport_ops {
+    const char *name;
+    int (*send)(struct ws2812_transport *t, const uint8_t *buf, size_t len);
+    void (*close)(struct ws2812_transport *t);
+};
+
+// spidev copies a whole SPI_IOC_MESSAGE into one bounce buffer of 'bufsiz'
+// bytes (a module parameter, 4096 unless raised), so that is the largest
+// frame one message can carry - about 170 LEDs in the 8-bit encoding.
+// Frames are queued on a ws2812_spi batch as chunks of at most
+// WS2812_SPI_CHUNK_BYTES and sent as a single SPI_IOC_MESSAGE(n), back to
+// back with no delay or CS change in between, so the chain never sees a gap
+// long enough to latch mid-frame.
+#define WS2812_SPI_CHUNK_BYTES 16384
+#define WS2812_SPI_MAX_CHUNKS 64
+
+struct ws2812_transport {
+    const struct ws2812_transport_ops *ops;
+    int fd;
+    enum ws2812_mode mode;
+    uint32_t speed_hz;
+    uint16_t latch_usecs;
+
+    struct ws2812_spi spi;  // spidev: the device and its transfer queue
+    size_t chunk_bytes;     // largest single transfer within a message
+
+    // Mock backends: the last frame decoded back to GRB
+    uint8_t *decoded;
+    size_t decoded_len;
+    size_t decoded_cap;
+    uint64_t frames;
+    struct sockaddr_un peer;
+};
+
+// Open the backend named by path. Returns 0, or -1 with errno set.
+int ws2812_transport_open(struct ws2812_transport *t, const char *path, enum ws2812_mode mode);
+
+// Send one encoded frame followed by the latch delay.
+// Returns 0, or -1 with errno set.
+int ws2812_transport_send(struct ws2812_transport *t, const uint8_t *buf, size_t len);
+
+void ws2812_transport_close(struct ws2812_transport *t);
+
+// The device path from WS2812_DEVICE, or def when it is not set.
+// WS2812_DEVICE=mock: runs any program without the LEDs attached.
+const char *ws2812_device_from_env(const char *def);
+
+#endif
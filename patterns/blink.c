@@ -0,0 +1,18 @@
+#include "patterns.h"
+
+// Dim green on, off, every half second
+static void render(void *state, struct ws2812 *dev, const struct ws2812_layout *l, uint32_t t) {
+    (void)state;
+    (void)l;
+    if (t & 1) {
+        ws2812_clear(dev);
+    } else {
+        ws2812_fill(dev, 0x00, 0x10, 0x00);
+    }
+}
+
+const struct ws2812_pattern pattern_blink = {
+    .name = "blink",
+    .period_us = 500000,
+    .render = render,
+};
@@ -0,0 +1,58 @@
+#include <stdlib.h>
+
+#include "patterns.h"
+#include "ws2812_sprite.h"
+
+// 1 = Rainbow Color, 0 = Off, one byte per row
+// This is a simple 8x8 Heart shape, repeated over bigger canvases
+static const uint8_t heart_bits[8] = {
+    0b01100110,
+    0b11111111,
+    0b11111111,
+    0b11111111,
+    0b01111110,
+    0b00111100,
+    0b00011000,
+    0b00000000
+};
+
+static int init(void **state, const struct ws2812_layout *l) {
+    struct ws2812_sprite *heart = malloc(sizeof(*heart));
+    (void)l;
+    if (heart == NULL) return -1;
+    if (ws2812_sprite_from_bits(heart, heart_bits, 8, 8) < 0) {
+        free(heart);
+        return -1;
+    }
+    *state = heart;
+    return 0;
+}
+
+static void render(void *state, struct ws2812 *dev, const struct ws2812_layout *l, uint32_t t) {
+    struct ws2812_sprite *heart = state;
+    uint8_t hue_offset = (uint8_t)(t * 4);
+
+    // The hearts never move, so the rest of the frame stays off
+    for (int y = 0; y < l->height; y += 8) {
+        for (int x = 0; x < l->width; x += 8) {
+            for (size_t k = 0; k < heart->count; k++) {
+                uint8_t *c = heart->grb + k * 3;
+                ws2812_hue_to_rgb(hue_offset + ((x + heart->x[k]) * 15), 255, &c[1], &c[0], &c[2]);
+            }
+            ws2812_sprite_draw(dev, l, heart, x, y, WS2812_BLEND_COPY, 255);
+        }
+    }
+}
+
+static void fini(void *state) {
+    ws2812_sprite_free(state);
+    free(state);
+}
+
+const struct ws2812_pattern pattern_heart = {
+    .name = "heart",
+    .period_us = 30000,
+    .init = init,
+    .render = render,
+    .fini = fini,
+};
@@ -0,0 +1,20 @@
+#ifndef PATTERNS_H
+#define PATTERNS_H
+
+#include "ws2812_pattern.h"
+
+// Patterns built into ws2812_play. The standalone programs are each one of
+// them run on its own through pattern_run().
+extern const struct ws2812_pattern pattern_rainbow;        // rainbow, 2rainbow, 3rainbow
+extern const struct ws2812_pattern pattern_wave;           // 4rainbow
+extern const struct ws2812_pattern pattern_wave_vertical;  // 4rainbow -r 1
+extern const struct ws2812_pattern pattern_heart;          // 5rainbow-heart
+extern const struct ws2812_pattern pattern_snake;          // 6rainbow-snake
+extern const struct ws2812_pattern pattern_blink;          // cool
+
+// Run one pattern on the device until SIGINT or SIGTERM, then blank the
+// strip: the whole of each standalone program. brightness is 0.0 to 1.0, or
+// negative to keep full brightness. Returns main()'s exit status.
+int pattern_run(const struct ws2812_pattern *p, float brightness);
+
+#endif
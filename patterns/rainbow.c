@@ -0,0 +1,15 @@
+#include "patterns.h"
+
+// Rainbow along the whole chain, cycling
+static void render(void *state, struct ws2812 *dev, const struct ws2812_layout *l, uint32_t t) {
+    (void)state;
+    (void)l;
+    // Change the '5' to adjust how "stretched" the rainbow is
+    ws2812_hue_fill(dev->pixels, dev->led_count, (uint8_t)(t * 2), 5, 255);
+}
+
+const struct ws2812_pattern pattern_rainbow = {
+    .name = "rainbow",
+    .period_us = 20000,
+    .render = render,
+};
@@ -0,0 +1,70 @@
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "patterns.h"
+#include "ws2812_pipeline.h"
+
+#define SPI_DEVICE "/dev/spidev0.0"
+
+static volatile sig_atomic_t g_stop;
+
+static void on_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+int pattern_run(const struct ws2812_pattern *p, float brightness) {
+    // Chain size and panel wiring (WS2812_LAYOUT), one 8x8 panel by default
+    struct ws2812_layout_config lc;
+    ws2812_layout_default(&lc);
+    ws2812_layout_from_env(&lc);
+    struct ws2812_layout layout;
+    if (ws2812_layout_init(&layout, &lc) < 0) { perror("Bad LED layout"); return 1; }
+
+    struct ws2812 dev;
+    if (ws2812_open(&dev, ws2812_device_from_env(SPI_DEVICE), layout.count, ws2812_mode_from_env()) < 0) { perror("Can't open SPI device"); return 1; }
+
+    static struct ws2812_engine engine;
+    ws2812_engine_init(&engine, &dev, &layout);
+    if (ws2812_engine_add(&engine, p) < 0) { perror(p->name); return 1; }
+
+    // Brightness + gamma/white point (WS2812_GAMMA, WS2812_WHITE) as one table lookup
+    struct ws2812_correction corr;
+    ws2812_correction_default(&corr);
+    if (brightness >= 0) corr.brightness = ws2812_brightness_level(brightness);
+    ws2812_correction_from_env(&corr);
+    ws2812_set_correction(&dev, &corr);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    ws2812_sched_fifo_from_env();
+    ws2812_stats_from_env(&dev);     // stage timings for build/ws2812_stat (WS2812_STATS)
+
+    // Render the next frame while the writer thread sends this one
+    struct ws2812_pipeline pipe;
+    if (ws2812_pipeline_start(&pipe, &dev) < 0) { perror("Can't start SPI writer"); return 1; }
+
+    struct ws2812_clock clk;
+    ws2812_clock_init(&clk, p->period_us);
+    clk.stats = dev.stats;
+
+    while (!g_stop) {
+        ws2812_pipeline_begin(&pipe);
+        ws2812_engine_render(&engine);
+        ws2812_pipeline_submit(&pipe);
+        ws2812_clock_wait(&clk);
+    }
+
+    ws2812_pipeline_stop(&pipe);
+    ws2812_clear(&dev);
+    ws2812_show(&dev);
+    ws2812_close(&dev);
+    ws2812_engine_free(&engine);
+    ws2812_layout_free(&layout);
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <stdlib.h>
+
+#include "patterns.h"
+#include "ws2812_sprite.h"
+
+#define SNAKE_LEN 15
+
+// A 15 LED snake spiralling in from the outside of the canvas
+struct snake {
+    struct ws2812_map path;         // chain index of every step
+    uint8_t tail_level[SNAKE_LEN];  // brightness of each segment, head first
+};
+
+static int init(void **state, const struct ws2812_layout *l) {
+    struct snake *s = malloc(sizeof(*s));
+    if (s == NULL) return -1;
+    if (ws2812_map_spiral(&s->path, l->width, l->height) < 0) {
+        free(s);
+        return -1;
+    }
+    ws2812_map_chain(&s->path, l);
+
+    for (int j = 0; j < SNAKE_LEN; j++) {
+        s->tail_level[j] = ws2812_brightness_level((float)(SNAKE_LEN - j) / SNAKE_LEN);
+    }
+    *state = s;
+    return 0;
+}
+
+static void render(void *state, struct ws2812 *dev, const struct ws2812_layout *l, uint32_t t) {
+    struct snake *s = state;
+    size_t n = s->path.count;
+    if (n == 0) return;
+    size_t head = t % n;
+    uint8_t hue_offset = (uint8_t)(t * 5);
+    uint32_t body[SNAKE_LEN];
+    uint8_t body_grb[SNAKE_LEN * 3];
+    (void)l;
+
+    // The frame still holds the last one: only the LED the tail just left
+    // needs turning off
+    ws2812_clear_list(dev, &s->path.index[(head + n - SNAKE_LEN) % n], 1);
+
+    for (int j = 0; j < SNAKE_LEN; j++) {
+        body[j] = s->path.index[(head + n - j) % n];
+        uint8_t *c = body_grb + j * 3;
+        ws2812_hue_to_rgb(hue_offset + (j * 10), s->tail_level[j], &c[1], &c[0], &c[2]);
+    }
+    ws2812_draw_list(dev, body, body_grb, SNAKE_LEN, WS2812_BLEND_COPY, 255);
+}
+
+static void fini(void *state) {
+    struct snake *s = state;
+    ws2812_map_free(&s->path);
+    free(s);
+}
+
+const struct ws2812_pattern pattern_snake = {
+    .name = "snake",
+    .period_us = 50000,
+    .init = init,
+    .render = render,
+    .fini = fini,
+};
@@ -0,0 +1,38 @@
+// Example pattern module, built as build/patterns/sparkle.so and loaded at
+// startup with "ws2812_play -P build/patterns/sparkle.so". Random white sparks
+// that fade out.
+#include <stdlib.h>
+
+#include "ws2812_pattern.h"
+
+static void render(void *state, struct ws2812 *dev, const struct ws2812_layout *l, uint32_t t) {
+    unsigned *seed = state;
+    (void)l;
+    (void)t;
+    if (dev->led_count == 0) return;
+
+    // Fade what is there, then light a few new sparks
+    for (size_t i = 0; i < dev->led_count * 3; i++) dev->pixels[i] = ws2812_scale8(dev->pixels[i], 200);
+
+    size_t sparks = dev->led_count / 32 + 1;
+    for (size_t k = 0; k < sparks; k++) {
+        ws2812_set_pixel(dev, (size_t)rand_r(seed) % dev->led_count, 255, 255, 255);
+    }
+}
+
+static int init(void **state, const struct ws2812_layout *l) {
+    unsigned *seed = malloc(sizeof(*seed));
+    (void)l;
+    if (seed == NULL) return -1;
+    *seed = 12345;
+    *state = seed;
+    return 0;
+}
+
+const struct ws2812_pattern ws2812_pattern_module = {
+    .name = "sparkle",
+    .period_us = 30000,
+    .init = init,
+    .render = render,
+    .fini = free,
+};
@@ -0,0 +1,83 @@
+#include <stdlib.h>
+
+#include "patterns.h"
+
+// Rainbow gradient across the canvas: drawn along the rows of a source
+// canvas, then turned onto the LEDs with one gather
+struct wave {
+    int src_w, src_h;
+    struct ws2812_map frame_map;
+    uint8_t *canvas;
+};
+
+static int init(void **state, const struct ws2812_layout *l, int rotate) {
+    struct wave *w = calloc(1, sizeof(*w));
+    if (w == NULL) return -1;
+
+    w->src_w = rotate ? l->height : l->width;
+    w->src_h = rotate ? l->width : l->height;
+
+    struct ws2812_map turn, to_chain;
+    if (ws2812_map_rotate(&turn, w->src_w, w->src_h, rotate ? 90 : 0) < 0) goto fail;
+    if (ws2812_map_layout(&to_chain, l) < 0) {
+        ws2812_map_free(&turn);
+        goto fail;
+    }
+    int err = ws2812_map_compose(&w->frame_map, &turn, &to_chain);
+    ws2812_map_free(&turn);
+    ws2812_map_free(&to_chain);
+    if (err < 0) goto fail;
+
+    w->canvas = malloc(l->count * 3);
+    if (w->canvas == NULL) {
+        ws2812_map_free(&w->frame_map);
+        goto fail;
+    }
+    *state = w;
+    return 0;
+
+fail:
+    free(w);
+    return -1;
+}
+
+static int init_horizontal(void **state, const struct ws2812_layout *l) {
+    return init(state, l, 0);
+}
+
+static int init_vertical(void **state, const struct ws2812_layout *l) {
+    return init(state, l, 1);
+}
+
+static void render(void *state, struct ws2812 *dev, const struct ws2812_layout *l, uint32_t t) {
+    struct wave *w = state;
+    (void)l;
+
+    for (int y = 0; y < w->src_h; y++) {
+        ws2812_hue_fill(w->canvas + (size_t)y * w->src_w * 3, w->src_w, (uint8_t)(t * 2), 10, 255);
+    }
+    ws2812_map_gather(dev->pixels, w->canvas, &w->frame_map);
+}
+
+static void fini(void *state) {
+    struct wave *w = state;
+    ws2812_map_free(&w->frame_map);
+    free(w->canvas);
+    free(w);
+}
+
+const struct ws2812_pattern pattern_wave = {
+    .name = "wave",
+    .period_us = 20000,
+    .init = init_horizontal,
+    .render = render,
+    .fini = fini,
+};
+
+const struct ws2812_pattern pattern_wave_vertical = {
+    .name = "wave-vertical",
+    .period_us = 20000,
+    .init = init_vertical,
+    .render = render,
+    .fini = fini,
+};
@@ -0,0 +1,212 @@
+// The DDP receiver against packets from a socket over loopback: good pixel
+// data lands in the frame as G-R-B, and anything that would write outside it
+// ( offset + length past the end, offsets near UINT32_MAX that wrap a 32-bit
+// size_t ), truncated headers, queries, replies, storage and data that is not
+// 8-bit RGB are dropped without touching the frame.
+//
+//   make check
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "ws2812_ddp.h"
+
+#define LEDS 64
+#define CAP (LEDS * 3)
+#define GUARD 64
+#define FILL 0xA5
+
+static int failures;
+static struct ws2812_ddp ddp;
+static int tx = -1;
+static struct sockaddr_in addr;
+
+// The frame, with a guard behind it that nothing may write
+static uint8_t frame[CAP + GUARD];
+
+static int send_packet(const uint8_t *pkt, size_t len) {
+    return sendto(tx, pkt, len, 0, (struct sockaddr *)&addr, sizeof(addr)) == (ssize_t)len ? 0 : -1;
+}
+
+// Send one packet and apply it. Returns what ws2812_ddp_apply() did, or -2
+// if it never arrived.
+static int apply_one(const uint8_t *pkt, size_t len) {
+    if (send_packet(pkt, len) < 0) return -2;
+    if (ws2812_ddp_receive(&ddp, 1000) != 1) return -2;
+    return ws2812_ddp_apply(&ddp, 0, frame, LEDS);
+}
+
+static void header(uint8_t *pkt, uint8_t flags, uint8_t type, uint32_t offset, uint16_t len) {
+    pkt[0] = flags;
+    pkt[1] = 1;
+    pkt[2] = type;
+    pkt[3] = 1;
+    pkt[4] = offset >> 24;
+    pkt[5] = offset >> 16;
+    pkt[6] = offset >> 8;
+    pkt[7] = offset;
+    pkt[8] = len >> 8;
+    pkt[9] = len;
+}
+
+// A packet that must be dropped and leave the frame as it was
+static void dropped(const char *what, const uint8_t *pkt, size_t len) {
+    memset(frame, FILL, sizeof(frame));
+    uint64_t bad = ddp.stats.bad;
+
+    int got = apply_one(pkt, len);
+    int untouched = 1;
+    for (size_t i = 0; i < sizeof(frame); i++) untouched &= frame[i] == FILL;
+    if (got != -1 || !untouched || ddp.stats.bad != bad + 1) {
+        fprintf(stderr, "FAIL %s: applied as %d, frame %s, %llu dropped\n", what, got,
+                untouched ? "untouched" : "written", (unsigned long long)(ddp.stats.bad - bad));
+        failures++;
+    }
+}
+
+// A packet of pixels that must land at offset, and nowhere else
+static void accepted(const char *what, const uint8_t *pkt, size_t len, int want) {
+    size_t header_len = WS2812_DDP_HEADER_LEN + ((pkt[0] & WS2812_DDP_FLAG_TIME) ? 4 : 0);
+    uint32_t offset = (uint32_t)pkt[4] << 24 | (uint32_t)pkt[5] << 16 | (uint32_t)pkt[6] << 8 | pkt[7];
+    size_t data = (size_t)pkt[8] << 8 | pkt[9];
+    memset(frame, FILL, sizeof(frame));
+
+    int got = apply_one(pkt, len);
+    int ok = got == want;
+    for (size_t i = 0; i < sizeof(frame); i++) {
+        uint8_t expect = FILL;
+        if (i >= offset && i < offset + data) {
+            // R-G-B on the wire, G-R-B in the frame
+            static const int from[3] = { 1, 0, 2 };
+            size_t px = (i - offset) / 3;
+            expect = pkt[header_len + px * 3 + from[(i - offset) % 3]];
+        }
+        ok &= frame[i] == expect;
+    }
+    if (!ok) {
+        fprintf(stderr, "FAIL %s: applied as %d (want %d), frame %s\n", what, got, want,
+                got == want ? "wrong" : "as sent");
+        failures++;
+    }
+}
+
+int main(void) {
+    // Clear of a running ws2812d and of ddp-bench
+    int port;
+    for (port = WS2812_DDP_PORT + 2; port < WS2812_DDP_PORT + 20; port++) {
+        if (ws2812_ddp_open(&ddp, port) == 0) break;
+    }
+    if (port == WS2812_DDP_PORT + 20) { perror("Can't open UDP port"); return 1; }
+
+    tx = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (tx < 0) { perror("socket"); return 1; }
+
+    uint8_t pkt[WS2812_DDP_HEADER_LEN + 4 + WS2812_DDP_MAX_DATA];
+    uint8_t rgb[CAP + 6];
+    for (size_t i = 0; i < sizeof(rgb); i++) rgb[i] = (uint8_t)(i * 7 + 1);
+
+    // Good data: the whole frame, one pixel at each end, no data with PUSH
+    accepted("whole frame", pkt, ws2812_ddp_pack(pkt, 1, 0, rgb, CAP, 1), 1);
+    accepted("first pixel", pkt, ws2812_ddp_pack(pkt, 1, 0, rgb, 3, 0), 0);
+    accepted("last pixel", pkt, ws2812_ddp_pack(pkt, 1, CAP - 3, rgb, 3, 0), 0);
+    accepted("push only", pkt, ws2812_ddp_pack(pkt, 1, 0, NULL, 0, 1), 1);
+    accepted("empty at the end", pkt, ws2812_ddp_pack(pkt, 1, CAP, NULL, 0, 0), 0);
+
+    // Type 0 ( undefined ) is what many senders use
+    ws2812_ddp_pack(pkt, 1, 3, rgb, 6, 0);
+    pkt[2] = 0;
+    accepted("undefined data type", pkt, WS2812_DDP_HEADER_LEN + 6, 0);
+
+    // A timecode moves the data back 4 bytes
+    header(pkt, WS2812_DDP_FLAG_VER1 | WS2812_DDP_FLAG_TIME, WS2812_DDP_TYPE_RGB8, 6, 6);
+    memset(pkt + WS2812_DDP_HEADER_LEN, 0xEE, 4);
+    memcpy(pkt + WS2812_DDP_HEADER_LEN + 4, rgb, 6);
+    accepted("with timecode", pkt, WS2812_DDP_HEADER_LEN + 4 + 6, 0);
+
+    // Past the end of the frame
+    dropped("offset + length past the end", pkt, ws2812_ddp_pack(pkt, 1, CAP - 3, rgb, 6, 1));
+    dropped("offset at the end", pkt, ws2812_ddp_pack(pkt, 1, CAP, rgb, 3, 1));
+    dropped("one frame too far", pkt, ws2812_ddp_pack(pkt, 1, CAP * 2, rgb, 3, 1));
+
+    // offset + len wraps to a small number in 32 bits
+    static const uint32_t huge[] = { 0xFFFFFFFCu, 0xFFFFFFF9u, 0x7FFFFFFEu, 0x80000001u };
+    for (size_t k = 0; k < sizeof(huge) / sizeof(huge[0]); k++) {
+        char what[64];
+        snprintf(what, sizeof(what), "offset 0x%08X", (unsigned)huge[k]);
+        dropped(what, pkt, ws2812_ddp_pack(pkt, 1, huge[k], rgb, 6, 1));
+    }
+
+    // Partial pixels
+    dropped("offset not a whole pixel", pkt, ws2812_ddp_pack(pkt, 1, 1, rgb, 3, 1));
+    dropped("length not a whole pixel", pkt, ws2812_ddp_pack(pkt, 1, 0, rgb, 4, 1));
+
+    // Truncated: no header, half a header, a timecode cut off, less data than
+    // the length says
+    ws2812_ddp_pack(pkt, 1, 0, rgb, 6, 1);
+    dropped("empty datagram", pkt, 0);
+    dropped("half a header", pkt, WS2812_DDP_HEADER_LEN / 2);
+    dropped("header only, length 6", pkt, WS2812_DDP_HEADER_LEN);
+    dropped("data cut short", pkt, WS2812_DDP_HEADER_LEN + 3);
+    header(pkt, WS2812_DDP_FLAG_VER1 | WS2812_DDP_FLAG_TIME | WS2812_DDP_FLAG_PUSH, WS2812_DDP_TYPE_RGB8, 0, 0);
+    dropped("timecode cut short", pkt, WS2812_DDP_HEADER_LEN + 2);
+
+    // Not version 1
+    static const uint8_t versions[] = { 0x00, 0x80, 0xC0 };
+    for (size_t k = 0; k < sizeof(versions); k++) {
+        ws2812_ddp_pack(pkt, 1, 0, rgb, 6, 1);
+        pkt[0] = versions[k] | WS2812_DDP_FLAG_PUSH;
+        dropped("not version 1", pkt, WS2812_DDP_HEADER_LEN + 6);
+    }
+
+    // Not pixel data
+    static const struct { uint8_t flag; const char *what; } flags[] = {
+        { WS2812_DDP_FLAG_QUERY, "query" },
+        { WS2812_DDP_FLAG_REPLY, "reply" },
+        { WS2812_DDP_FLAG_STORAGE, "storage" },
+    };
+    for (size_t k = 0; k < sizeof(flags) / sizeof(flags[0]); k++) {
+        ws2812_ddp_pack(pkt, 1, 0, rgb, 6, 1);
+        pkt[0] |= flags[k].flag;
+        dropped(flags[k].what, pkt, WS2812_DDP_HEADER_LEN + 6);
+    }
+    static const uint8_t types[] = { 0x01, 0x0A, 0x0C, 0x1B, 0x13, 0xFF };
+    for (size_t k = 0; k < sizeof(types); k++) {
+        char what[64];
+        snprintf(what, sizeof(what), "data type 0x%02X", types[k]);
+        ws2812_ddp_pack(pkt, 1, 0, rgb, 6, 1);
+        pkt[2] = types[k];
+        dropped(what, pkt, WS2812_DDP_HEADER_LEN + 6);
+    }
+
+    // A batch: one receive takes every queued packet, each applied on its own
+    memset(frame, FILL, sizeof(frame));
+    for (int k = 0; k < 4; k++) {
+        size_t len = ws2812_ddp_pack(pkt, 1, (uint32_t)(k * 3), rgb + k * 3, 3, k == 3);
+        if (k == 2) pkt[0] |= WS2812_DDP_FLAG_QUERY;
+        send_packet(pkt, len);
+    }
+    int n = ws2812_ddp_receive(&ddp, 1000);
+    int pushes = 0, drops = 0;
+    for (int i = 0; i < n; i++) {
+        int got = ws2812_ddp_apply(&ddp, i, frame, LEDS);
+        pushes += got == 1;
+        drops += got == -1;
+    }
+    if (n != 4 || pushes != 1 || drops != 1 || frame[6] != FILL || frame[9] != rgb[10] || frame[12] != FILL) {
+        fprintf(stderr, "FAIL batch: %d packets, %d pushes, %d dropped\n", n, pushes, drops);
+        failures++;
+    }
+
+    close(tx);
+    ws2812_ddp_close(&ddp);
+    if (failures) return 1;
+    printf("ddp: ok\n");
+    return 0;
+}
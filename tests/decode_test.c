@@ -0,0 +1,99 @@
+// ws2812_decode() against the encoders: every byte value and random LED
+// buffers must come back unchanged in the 8-, 4- and 3-bit modes, and a
+// stream with any one symbol that is neither a '0' nor a '1' must be
+// rejected, wherever that symbol is.
+//
+//   make check
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ws2812_encode.h"
+
+static int failures;
+
+static const enum ws2812_mode modes[] = { WS2812_MODE_8BIT, WS2812_MODE_4BIT, WS2812_MODE_3BIT };
+
+#define MAX_LEN (3 * 300)
+
+static uint8_t src[MAX_LEN], spi[MAX_LEN * 8], back[MAX_LEN];
+
+static void round_trip(enum ws2812_mode mode, const char *what, size_t len) {
+    ws2812_encode_mode(mode, spi, src, len);
+    memset(back, 0, len);
+    long got = ws2812_decode(mode, back, spi, ws2812_encoded_size(mode, len));
+    if (got != (long)len || memcmp(back, src, len) != 0) {
+        fprintf(stderr, "FAIL %d-bit round trip, %s (%zu bytes): decoded %ld bytes%s\n",
+                (int)mode, what, len, got, got == (long)len ? ", different" : "");
+        failures++;
+    }
+}
+
+// Overwrite the width-bit symbol number n of an SPI stream, MSB first
+static void put_symbol(uint8_t *stream, unsigned width, size_t n, unsigned sym) {
+    for (unsigned k = 0; k < width; k++) {
+        size_t pos = n * width + k;
+        uint8_t mask = (uint8_t)(0x80 >> (pos % 8));
+        if ((sym >> (width - 1 - k)) & 1) stream[pos / 8] |= mask;
+        else stream[pos / 8] &= (uint8_t)~mask;
+    }
+}
+
+static void rejects(enum ws2812_mode mode, size_t len) {
+    unsigned width = (unsigned)mode;
+    unsigned sym_0 = mode == WS2812_MODE_8BIT ? WS2812_0 : mode == WS2812_MODE_4BIT ? 0x8 : 0x4;
+    unsigned sym_1 = mode == WS2812_MODE_8BIT ? WS2812_1 : mode == WS2812_MODE_4BIT ? 0xE : 0x6;
+    size_t symbols = len * 8;
+
+    for (int round = 0; round < 200; round++) {
+        unsigned bad;
+        do {
+            bad = (unsigned)rand() & ((1u << width) - 1);
+        } while (bad == sym_0 || bad == sym_1);
+        size_t at = round == 0 ? 0 : round == 1 ? symbols - 1 : (size_t)rand() % symbols;
+
+        ws2812_encode_mode(mode, spi, src, len);
+        put_symbol(spi, width, at, bad);
+        long got = ws2812_decode(mode, back, spi, ws2812_encoded_size(mode, len));
+        if (got != -1) {
+            fprintf(stderr, "FAIL %d-bit: symbol 0x%X at %zu of %zu decoded as %ld bytes instead of -1\n",
+                    (int)mode, bad, at, symbols, got);
+            failures++;
+        }
+    }
+}
+
+int main(void) {
+    srand(2812);
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        enum ws2812_mode mode = modes[m];
+
+        for (int v = 0; v < 256; v++) src[v] = (uint8_t)v;
+        round_trip(mode, "all byte values", 256);
+
+        for (int round = 0; round < 500; round++) {
+            // Whole LEDs, 0 .. 300 of them
+            size_t len = 3 * ((size_t)rand() % (MAX_LEN / 3 + 1));
+            for (size_t i = 0; i < len; i++) src[i] = (uint8_t)rand();
+            round_trip(mode, "random LEDs", len);
+        }
+
+        // A stream cut short decodes only the whole bytes in it
+        for (size_t i = 0; i < 30; i++) src[i] = (uint8_t)rand();
+        ws2812_encode_mode(mode, spi, src, 30);
+        long got = ws2812_decode(mode, back, spi, ws2812_encoded_size(mode, 30) - 1);
+        if (got != 29 || memcmp(back, src, 29) != 0) {
+            fprintf(stderr, "FAIL %d-bit: truncated stream decoded as %ld bytes, want 29\n", (int)mode, got);
+            failures++;
+        }
+
+        for (size_t i = 0; i < 30; i++) src[i] = (uint8_t)rand();
+        rejects(mode, 30);
+    }
+
+    if (failures) return 1;
+    printf("decode: ok\n");
+    return 0;
+}
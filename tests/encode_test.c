@@ -0,0 +1,75 @@
+// The table encoder ( and the NEON one, in a NEON build ) against the
+// original per-bit loop, ws2812_encode_ref(): every byte value, then random
+// buffers of many lengths at every alignment, so the 8-byte NEON blocks and
+// the scalar tail both run. Also the WS2812_MODE parser.
+//
+//   make check
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ws2812_encode.h"
+
+static int failures;
+
+static void check_same(const char *what, const uint8_t *got, const uint8_t *want, size_t len, size_t src_len) {
+    if (memcmp(got, want, len) == 0) return;
+    size_t i = 0;
+    while (got[i] == want[i]) i++;
+    fprintf(stderr, "FAIL %s (%zu bytes): SPI byte %zu is 0x%02X, the bit loop gives 0x%02X\n",
+            what, src_len, i, got[i], want[i]);
+    failures++;
+}
+
+int main(void) {
+    enum { MAX_LEN = 3 * 300 + 7 };
+    static uint8_t src[MAX_LEN + 16], got[(MAX_LEN + 16) * 8], want[(MAX_LEN + 16) * 8];
+
+    // Every byte value, in one buffer
+    for (int v = 0; v < 256; v++) src[v] = (uint8_t)v;
+    ws2812_encode_ref(want, src, 256);
+    ws2812_encode(got, src, 256);
+    check_same("all byte values, ws2812_encode", got, want, 256 * 8, 256);
+    ws2812_encode_scalar(got, src, 256);
+    check_same("all byte values, ws2812_encode_scalar", got, want, 256 * 8, 256);
+
+    // Random LED buffers: lengths 0 .. MAX_LEN, source at offsets 0-7
+    srand(2812);
+    for (int round = 0; round < 2000; round++) {
+        size_t len = (size_t)rand() % (MAX_LEN + 1);
+        size_t shift = (size_t)rand() % 8;
+        uint8_t *in = src + shift;
+        for (size_t i = 0; i < len; i++) in[i] = (uint8_t)rand();
+
+        // Past the end stays untouched
+        memset(got, 0xA5, (len + 1) * 8);
+        ws2812_encode_ref(want, in, len);
+        ws2812_encode(got, in, len);
+        check_same("random buffer", got, want, len * 8, len);
+        if (got[len * 8] != 0xA5) {
+            fprintf(stderr, "FAIL random buffer (%zu bytes): wrote past the end\n", len);
+            failures++;
+        }
+        if (failures > 10) break;
+    }
+
+    // Mode names: exactly 8, 4 or 3
+    static const struct { const char *s; int mode; } names[] = {
+        { "8", WS2812_MODE_8BIT }, { "4", WS2812_MODE_4BIT }, { "3", WS2812_MODE_3BIT },
+        { "", -1 }, { "4x", -1 }, { " 3", -1 }, { "3 ", -1 }, { "+4", -1 }, { "-8", -1 },
+        { "2", -1 }, { "16", -1 }, { "x", -1 }, { "8.0", -1 },
+    };
+    for (size_t k = 0; k < sizeof(names) / sizeof(names[0]); k++) {
+        enum ws2812_mode mode = WS2812_MODE_8BIT;
+        int ret = ws2812_parse_mode(names[k].s, &mode);
+        if (names[k].mode < 0 ? ret != -1 : ret != 0 || (int)mode != names[k].mode) {
+            fprintf(stderr, "FAIL ws2812_parse_mode(\"%s\") returned %d, mode %d\n", names[k].s, ret, (int)mode);
+            failures++;
+        }
+    }
+
+    if (failures) return 1;
+    printf("encode: ok\n");
+    return 0;
+}
@@ -1,65 +1,49 @@
 #include <stdint.h>
 #include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <unistd.h>
-#include <fcntl.h>
-#include <sys/ioctl.h>
-#include <linux/spi/spidev.h>
 
-#define LED_COUNT 64
-#define BITS_PER_RGB 24
-#define SPI_DEVICE "/dev/spidev0.0"
-
-// WS2812B "Bit" encoding via SPI bytes
-#define WS2812_0 0xC0
-#define WS2812_1 0xFC
-
-void transmit_leds(int fd, uint8_t *rgb_data) {
-    size_t buffer_size = LED_COUNT * BITS_PER_RGB;
-    uint8_t *spi_buf = malloc(buffer_size);
-
-    for (int i = 0; i < LED_COUNT * 3; i++) {
-        for (int bit = 7; bit >= 0; bit--) {
-            spi_buf[i * 8 + (7 - bit)] = (rgb_data[i] & (1 << bit)) ? WS2812_1 : WS2812_0;
-        }
-    }
+#include "ws2812.h"
 
-    struct spi_ioc_transfer tr = {
-        .tx_buf = (unsigned long)spi_buf,
-        .len = buffer_size,
-        .speed_hz = 6400000,
-        .bits_per_word = 8,
-    };
-
-    ioctl(fd, SPI_IOC_MESSAGE(1), &tr);
-    free(spi_buf);
-}
+#define SPI_DEVICE "/dev/spidev0.0"
 
 int main() {
-    int fd = open(SPI_DEVICE, O_RDWR);
-    if (fd < 0) { 
+    // Chain size and panel wiring (WS2812_LAYOUT), one 8x8 panel by default
+    struct ws2812_layout_config lc;
+    ws2812_layout_default(&lc);
+    ws2812_layout_from_env(&lc);
+    struct ws2812_layout layout;
+    if (ws2812_layout_init(&layout, &lc) < 0) { perror("Bad LED layout"); return 1; }
+
+    struct ws2812 dev;
+    if (ws2812_open(&dev, ws2812_device_from_env(SPI_DEVICE), layout.count, ws2812_mode_from_env()) < 0) { 
         perror("Can't open SPI device - check if SPI is enabled in config.txt"); 
         return 1; 
     }
 
-    uint8_t leds[LED_COUNT * 3] = {0};
+    // Brightness + gamma/white point (WS2812_GAMMA, WS2812_WHITE) as one table lookup
+    struct ws2812_correction corr;
+    ws2812_correction_default(&corr);
+    ws2812_correction_from_env(&corr);
+    ws2812_set_correction(&dev, &corr);
+
     printf("Actuating 64 LED Grid via Generic SPI Controller...\n");
 
+    struct ws2812_clock clk;
+    ws2812_sched_fifo_from_env();
+    ws2812_stats_from_env(&dev);     // stage timings for build/ws2812_stat (WS2812_STATS)
+    ws2812_clock_init(&clk, 500000);
+    clk.stats = dev.stats;
+
     while (1) {
-        for (int i = 0; i < LED_COUNT * 3; i += 3) {
-            leds[i] = 0x20;   // Green
-            leds[i+1] = 0x00; // Red
-            leds[i+2] = 0x00; // Blue
-        }
-        transmit_leds(fd, leds);
-        usleep(500000);
+        ws2812_fill(&dev, 0x00, 0x20, 0x00); // Green
+        ws2812_show(&dev);
+        ws2812_clock_wait(&clk);
 
-        memset(leds, 0, sizeof(leds));
-        transmit_leds(fd, leds);
-        usleep(500000);
+        ws2812_clear(&dev);
+        ws2812_show(&dev);
+        ws2812_clock_wait(&clk);
     }
 
-    close(fd);
+    ws2812_close(&dev);
+    ws2812_layout_free(&layout);
     return 0;
 }
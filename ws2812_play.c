@@ -0,0 +1,268 @@
+// ws2812_play - every pattern in one process. The device, the SPI writer
+// thread and all pattern state stay up, so switching patterns is a pointer
+// change between two frames instead of a program restart.
+//
+//   ./build/ws2812_play [-b brightness] [-c fifo] [-P module.so]...
+//                       [-t cut|fade|wipe] [-f frames] [pattern]
+//
+// Built-in patterns: rainbow, wave, wave-vertical, heart, snake, blink.
+// -P loads a pattern module (see patterns/sparkle.c); modules are only
+// taken at startup. Switching:
+//   kill -USR1 <pid>                      next pattern
+//   echo heart > fifo                     pattern by name
+//   echo next > fifo
+//
+// The FIFO is created mode 0660, or reused if it already is a FIFO of ours.
+//
+// A switch crossfades over 50 frames by default; -t wipe sweeps the new
+// pattern in along a spiral instead, -t cut switches on the next frame.
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ws2812.h"
+#include "ws2812_pattern.h"
+#include "ws2812_pipeline.h"
+#include "patterns/patterns.h"
+
+#define SPI_DEVICE "/dev/spidev0.0"
+
+static const struct ws2812_pattern *const builtin[] = {
+    &pattern_rainbow,
+    &pattern_wave,
+    &pattern_wave_vertical,
+    &pattern_heart,
+    &pattern_snake,
+    &pattern_blink,
+};
+
+static volatile sig_atomic_t g_stop;
+static volatile sig_atomic_t g_next;
+
+static void on_signal(int sig) {
+    if (sig == SIGUSR1) {
+        g_next = 1;
+    } else {
+        g_stop = 1;
+    }
+}
+
+// One command line from the FIFO, handed to the render loop. Only the
+// render loop touches the engine.
+struct control {
+    int fd;
+    pthread_mutex_t lock;
+    char command[256];
+    atomic_int pending;
+};
+
+static void *control_main(void *arg) {
+    struct control *ctl = arg;
+    char line[256];
+    size_t len = 0;
+
+    while (!g_stop) {
+        struct pollfd pfd = { .fd = ctl->fd, .events = POLLIN };
+        if (poll(&pfd, 1, 100) <= 0) continue;
+
+        ssize_t n = read(ctl->fd, line + len, sizeof(line) - 1 - len);
+        if (n <= 0) continue;
+        len += n;
+
+        char *nl;
+        while ((nl = memchr(line, '\n', len)) != NULL) {
+            *nl = '\0';
+            pthread_mutex_lock(&ctl->lock);
+            snprintf(ctl->command, sizeof(ctl->command), "%s", line);
+            atomic_store_explicit(&ctl->pending, 1, memory_order_release);
+            pthread_mutex_unlock(&ctl->lock);
+
+            len -= nl + 1 - line;
+            memmove(line, nl + 1, len);
+        }
+        // Overlong line: drop it
+        if (len == sizeof(line) - 1) len = 0;
+    }
+    return NULL;
+}
+
+// Returns the index to switch to, or -1 to stay
+static int run_command(struct ws2812_engine *e, const char *cmd) {
+    if (strcmp(cmd, "next") == 0) return (e->current + 1) % e->count;
+
+    int index = ws2812_engine_find(e, cmd);
+    if (index < 0 && cmd[0] != '\0') fprintf(stderr, "No pattern called %s\n", cmd);
+    return index;
+}
+
+// Whoever can write the FIFO picks the pattern: take only a FIFO we own,
+// never a file or link someone left at the path
+static int open_fifo(const char *path) {
+    struct stat st;
+
+    if (mkfifo(path, 0660) < 0 && errno != EEXIST) return -1;
+    if (lstat(path, &st) < 0) return -1;
+    if (!S_ISFIFO(st.st_mode) || st.st_uid != geteuid()) {
+        errno = EPERM;
+        return -1;
+    }
+
+    // Read-write so the FIFO never reports EOF between writers
+    int fd = open(path, O_RDWR | O_CLOEXEC | O_NOFOLLOW);
+    if (fd < 0) return -1;
+    if (fstat(fd, &st) < 0 || !S_ISFIFO(st.st_mode) || st.st_uid != geteuid()) {
+        close(fd);
+        errno = EPERM;
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char *argv[]) {
+    float brightness = 0.3;
+    const char *fifo = NULL;
+    const char *modules[WS2812_MAX_PATTERNS];
+    int module_count = 0;
+    enum ws2812_transition transition = WS2812_TRANSITION_CROSSFADE;
+    uint32_t transition_frames = 50;
+    int opt;
+    while ((opt = getopt(argc, argv, "b:c:P:t:f:")) != -1) {
+        switch (opt) {
+            case 'b': brightness = atof(optarg); break;
+            case 'c': fifo = optarg; break;
+            case 'P':
+                if (module_count < WS2812_MAX_PATTERNS) modules[module_count++] = optarg;
+                break;
+            case 't':
+                if (strcmp(optarg, "cut") == 0) transition = WS2812_TRANSITION_CUT;
+                else if (strcmp(optarg, "wipe") == 0) transition = WS2812_TRANSITION_WIPE;
+                else transition = WS2812_TRANSITION_CROSSFADE;
+                break;
+            case 'f': transition_frames = (uint32_t)atoi(optarg); break;
+            default: fprintf(stderr, "Usage: %s [-b brightness] [-c control-fifo] [-P module.so]... [-t cut|fade|wipe] [-f frames] [pattern]\n", argv[0]); return 1;
+        }
+    }
+    const char *first = optind < argc ? argv[optind] : builtin[0]->name;
+
+    // Chain size and panel wiring (WS2812_LAYOUT), one 8x8 panel by default
+    struct ws2812_layout_config lc;
+    ws2812_layout_default(&lc);
+    ws2812_layout_from_env(&lc);
+    struct ws2812_layout layout;
+    if (ws2812_layout_init(&layout, &lc) < 0) { perror("Bad LED layout"); return 1; }
+
+    struct ws2812 dev;
+    if (ws2812_open(&dev, ws2812_device_from_env(SPI_DEVICE), layout.count, ws2812_mode_from_env()) < 0) { perror("Can't open SPI device"); return 1; }
+
+    // All patterns are set up now, so a switch never allocates
+    static struct ws2812_engine engine;
+    ws2812_engine_init(&engine, &dev, &layout);
+    for (size_t i = 0; i < sizeof(builtin) / sizeof(builtin[0]); i++) {
+        if (ws2812_engine_add(&engine, builtin[i]) < 0) { perror(builtin[i]->name); return 1; }
+    }
+    for (int i = 0; i < module_count; i++) {
+        if (ws2812_engine_load(&engine, modules[i]) < 0) return 1;
+    }
+    engine.current = ws2812_engine_find(&engine, first);
+    if (engine.current < 0) { fprintf(stderr, "No pattern called %s\n", first); return 1; }
+
+    // Wipes spiral in from the outside of the canvas
+    struct ws2812_map wipe_path;
+    if (ws2812_map_spiral(&wipe_path, layout.width, layout.height) < 0) { perror("Can't build wipe path"); return 1; }
+    ws2812_map_chain(&wipe_path, &layout);
+    ws2812_engine_set_wipe(&engine, &wipe_path);
+
+    // Brightness + gamma/white point (WS2812_GAMMA, WS2812_WHITE) as one table lookup
+    struct ws2812_correction corr;
+    ws2812_correction_default(&corr);
+    corr.brightness = ws2812_brightness_level(brightness);
+    ws2812_correction_from_env(&corr);
+    ws2812_set_correction(&dev, &corr);
+
+    // The handlers only set flags. The frame clock sleeps through signals,
+    // so a stop or switch takes effect at the next frame.
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGUSR1, &sa, NULL);
+
+    static struct control ctl = { .fd = -1, .lock = PTHREAD_MUTEX_INITIALIZER };
+    pthread_t control_thread;
+    if (fifo != NULL) {
+        ctl.fd = open_fifo(fifo);
+        if (ctl.fd < 0) { perror(fifo); return 1; }
+        if (pthread_create(&control_thread, NULL, control_main, &ctl) != 0) { perror("Can't start control thread"); return 1; }
+    }
+
+    ws2812_sched_fifo_from_env();
+    ws2812_stats_from_env(&dev);     // stage timings for build/ws2812_stat (WS2812_STATS)
+
+    // Render the next frame while the writer thread sends this one
+    struct ws2812_pipeline pipe;
+    if (ws2812_pipeline_start(&pipe, &dev) < 0) { perror("Can't start SPI writer"); return 1; }
+
+    long period = engine.slots[engine.current].pattern->period_us;
+    struct ws2812_clock clk;
+    ws2812_clock_init(&clk, period);
+    clk.stats = dev.stats;
+    printf("ws2812_play: %s\n", engine.slots[engine.current].pattern->name);
+
+    while (!g_stop) {
+        int next = -1;
+        if (g_next) {
+            g_next = 0;
+            next = (engine.current + 1) % engine.count;
+        }
+        if (atomic_load_explicit(&ctl.pending, memory_order_acquire)) {
+            char cmd[256];
+            pthread_mutex_lock(&ctl.lock);
+            memcpy(cmd, ctl.command, sizeof(cmd));
+            atomic_store_explicit(&ctl.pending, 0, memory_order_relaxed);
+            pthread_mutex_unlock(&ctl.lock);
+            next = run_command(&engine, cmd);
+        }
+        if (next >= 0 && next != engine.current) {
+            ws2812_engine_switch(&engine, next, transition, transition_frames);
+            printf("ws2812_play: %s\n", engine.slots[next].pattern->name);
+        }
+
+        ws2812_pipeline_begin(&pipe);
+        ws2812_engine_render(&engine);
+        ws2812_pipeline_submit(&pipe);
+
+        // Each pattern keeps the speed it was written for. The outgoing one
+        // sets it until a transition is over, so it does not jump mid-blend.
+        int pace = engine.from >= 0 ? engine.from : engine.current;
+        long want = engine.slots[pace].pattern->period_us;
+        if (want != period) {
+            period = want;
+            ws2812_clock_init(&clk, period);
+            clk.stats = dev.stats;
+        }
+        ws2812_clock_wait(&clk);
+    }
+
+    ws2812_pipeline_stop(&pipe);
+    if (ctl.fd >= 0) {
+        pthread_join(control_thread, NULL);
+        close(ctl.fd);
+    }
+    ws2812_clear(&dev);
+    ws2812_show(&dev);
+    ws2812_close(&dev);
+    ws2812_engine_free(&engine);
+    ws2812_map_free(&wipe_path);
+    ws2812_layout_free(&layout);
+    return 0;
+}
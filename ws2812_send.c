@@ -0,0 +1,94 @@
+// ws2812_send - stream a rainbow to a DDP receiver ( ws2812d -u, WLED, ... )
+// for testing the network path without a show controller.
+//
+//   ./build/ws2812_send [-h host] [-p port] [-l leds] [-f fps] [-n frames]
+//
+// Each frame goes out as packets of up to 480 pixels in one sendmmsg()
+// call, the last one carrying the PUSH flag.
+#define _GNU_SOURCE     // sendmmsg()
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "ws2812.h"
+#include "ws2812_ddp.h"
+
+#define MAX_PACKETS 64
+
+int main(int argc, char *argv[]) {
+    const char *host = "127.0.0.1";
+    int port = WS2812_DDP_PORT;
+    int leds = 64;
+    int fps = 50;
+    long frames = -1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "h:p:l:f:n:")) != -1) {
+        switch (opt) {
+            case 'h': host = optarg; break;
+            case 'p': port = atoi(optarg); break;
+            case 'l': leds = atoi(optarg); break;
+            case 'f': fps = atoi(optarg); break;
+            case 'n': frames = atol(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-h host] [-p port] [-l leds] [-f fps] [-n frames]\n", argv[0]);
+                return 1;
+        }
+    }
+    size_t per_packet = WS2812_DDP_MAX_DATA / 3;
+    if (leds <= 0 || fps <= 0 || fps > 1000000 || (leds + per_packet - 1) / per_packet > MAX_PACKETS) {
+        fprintf(stderr, "Use 1 to %zu LEDs and a frame rate of 1 to 1000000\n", per_packet * MAX_PACKETS);
+        return 1;
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (fd < 0 || inet_pton(AF_INET, host, &addr.sin_addr) != 1) { fprintf(stderr, "Bad host %s\n", host); return 1; }
+
+    uint8_t *rgb = malloc((size_t)leds * 3);
+    static uint8_t pkt[MAX_PACKETS][WS2812_DDP_HEADER_LEN + WS2812_DDP_MAX_DATA];
+    struct mmsghdr msgs[MAX_PACKETS];
+    struct iovec iov[MAX_PACKETS];
+    if (rgb == NULL) { perror("Out of memory"); return 1; }
+
+    struct ws2812_clock clk;
+    ws2812_clock_init(&clk, 1000000 / fps);
+
+    uint8_t hue_offset = 0;
+    uint8_t seq = 1;
+    for (long f = 0; frames < 0 || f < frames; f++) {
+        for (int i = 0; i < leds; i++) {
+            ws2812_hue_to_rgb(hue_offset + i * 5, 255, &rgb[i * 3], &rgb[i * 3 + 1], &rgb[i * 3 + 2]);
+        }
+
+        int n = 0;
+        for (size_t off = 0; off < (size_t)leds * 3; off += per_packet * 3, n++) {
+            size_t len = (size_t)leds * 3 - off < per_packet * 3 ? (size_t)leds * 3 - off : per_packet * 3;
+            int last = off + len == (size_t)leds * 3;
+
+            iov[n].iov_base = pkt[n];
+            iov[n].iov_len = ws2812_ddp_pack(pkt[n], seq, (uint32_t)off, rgb + off, len, last);
+            memset(&msgs[n], 0, sizeof(msgs[n]));
+            msgs[n].msg_hdr.msg_name = &addr;
+            msgs[n].msg_hdr.msg_namelen = sizeof(addr);
+            msgs[n].msg_hdr.msg_iov = &iov[n];
+            msgs[n].msg_hdr.msg_iovlen = 1;
+        }
+        if (sendmmsg(fd, msgs, n, 0) < n) perror("sendmmsg");
+
+        seq = seq % 15 + 1;     // DDP sequence numbers run 1..15
+        hue_offset += 2;
+        ws2812_clock_wait(&clk);
+    }
+
+    free(rgb);
+    close(fd);
+    return 0;
+}
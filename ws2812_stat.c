@@ -0,0 +1,89 @@
+// ws2812_stat - print the frame timings a pattern program records with
+// WS2812_STATS set (see ws2812_stats.h).
+//
+//   WS2812_STATS=/run/ws2812/snake.stats ./build/6rainbow-snake &
+//   ./build/ws2812_stat /run/ws2812/snake.stats          # since start
+//   ./build/ws2812_stat -i 1 /run/ws2812/snake.stats     # every second
+//
+// Times are in microseconds. Percentiles come from histogram buckets 12.5%
+// wide (1 us below 16 us), so they are that close, never above the max.
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ws2812_stats.h"
+
+static void print_stages(const struct ws2812_stage_snapshot *snaps) {
+    printf("%-8s %10s %9s %9s %9s %9s\n", "stage", "count", "p50", "p99", "max", "mean");
+    for (int i = 0; i < WS2812_STAGE_COUNT; i++) {
+        const struct ws2812_stage_snapshot *s = &snaps[i];
+        if (s->count == 0) {
+            printf("%-8s %10s\n", ws2812_stage_name(i), "-");
+            continue;
+        }
+        printf("%-8s %10llu %9.1f %9.1f %9.1f %9.1f\n", ws2812_stage_name(i), (unsigned long long)s->count,
+               ws2812_stats_percentile(s, 50) / 1e3, ws2812_stats_percentile(s, 99) / 1e3,
+               s->max_ns / 1e3, (double)s->total_ns / s->count / 1e3);
+    }
+}
+
+static void print_counters(const struct ws2812_stats *st, uint64_t errors, uint64_t missed, uint64_t skipped) {
+    int last = atomic_load_explicit(&st->last_error, memory_order_relaxed);
+    printf("send errors %llu%s%s, missed deadlines %llu, unchanged frames skipped %llu\n",
+           (unsigned long long)errors, errors ? ", last: " : "", errors ? strerror(last) : "",
+           (unsigned long long)missed, (unsigned long long)skipped);
+}
+
+int main(int argc, char *argv[]) {
+    int interval = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "i:")) != -1) {
+        switch (opt) {
+            case 'i': interval = atoi(optarg); break;
+            default: fprintf(stderr, "Usage: %s [-i seconds] [stats-file]\n", argv[0]); return 1;
+        }
+    }
+    const char *path = optind < argc ? argv[optind] : getenv("WS2812_STATS");
+    if (path == NULL) { fprintf(stderr, "No stats file (give one, or set WS2812_STATS)\n"); return 1; }
+
+    const struct ws2812_stats *st = ws2812_stats_attach(path);
+    if (st == NULL) { perror(path); return 1; }
+
+    int alive = kill(st->pid, 0) == 0 || errno == EPERM;
+    printf("%s: pid %d%s, %u LEDs\n", path, st->pid, alive ? "" : " (exited)", st->led_count);
+
+    static struct ws2812_stage_snapshot now[WS2812_STAGE_COUNT], before[WS2812_STAGE_COUNT], delta[WS2812_STAGE_COUNT];
+    for (int i = 0; i < WS2812_STAGE_COUNT; i++) ws2812_stats_snapshot(st, i, &now[i]);
+    uint64_t errors = atomic_load(&st->errors);
+    uint64_t missed = atomic_load(&st->missed);
+    uint64_t skipped = atomic_load(&st->skipped);
+
+    printf("\nsince start:\n");
+    print_stages(now);
+    print_counters(st, errors, missed, skipped);
+
+    // Each report covers the samples taken since the one before
+    while (interval > 0) {
+        sleep(interval);
+        memcpy(before, now, sizeof(now));
+        for (int i = 0; i < WS2812_STAGE_COUNT; i++) {
+            ws2812_stats_snapshot(st, i, &now[i]);
+            ws2812_stats_diff(&delta[i], &now[i], &before[i]);
+        }
+        uint64_t e = atomic_load(&st->errors), m = atomic_load(&st->missed), k = atomic_load(&st->skipped);
+
+        printf("\nlast %d s:\n", interval);
+        print_stages(delta);
+        print_counters(st, e - errors, m - missed, k - skipped);
+        fflush(stdout);
+        errors = e;
+        missed = m;
+        skipped = k;
+    }
+
+    ws2812_stats_close(st);
+    return 0;
+}
@@ -0,0 +1,174 @@
+// ws2812d - LED daemon. Owns the SPI device and shows the frames pattern
+// programs publish in shared memory, so patterns can be swapped without
+// restarting anything that touches SPI.
+//
+//   ./build/ws2812d [-n /ws2812] [-m 0660] [-u port] &
+//   WS2812_DEVICE=shm:/ws2812 ./build/6rainbow-snake
+//
+// The framebuffer is created mode 0660 ( less the umask ): pattern programs
+// run as the daemon's user or in its group. -m sets another mode, e.g. 0600.
+//
+// Device, layout, encoding and FIFO priority come from the same WS2812_*
+// variables as every pattern program. One pattern draws at a time.
+//
+// With -u the daemon also takes DDP frames over UDP (port 4048 is the
+// standard one, see ws2812_ddp.h) from a show controller or build/ws2812_send.
+// The network then is that one pattern: it draws into the shared frame like
+// any other client, so local patterns get EBUSY while it runs.
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ws2812.h"
+#include "ws2812_ddp.h"
+#include "ws2812_shm.h"
+
+#define SPI_DEVICE "/dev/spidev0.0"
+
+static volatile sig_atomic_t g_stop;
+
+static void on_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+struct ingest {
+    struct ws2812_ddp ddp;
+    struct ws2812_shm shm;      // client side of the daemon's own framebuffer
+};
+
+// Network "pattern": packets go straight into the shared back frame, a PUSH
+// publishes it to the main loop
+static void *ingest_main(void *arg) {
+    struct ingest *in = arg;
+    size_t led_count = in->shm.hdr->led_count;
+
+    while (!g_stop) {
+        int n = ws2812_ddp_receive(&in->ddp, 100);
+        if (n < 0) {
+            perror("UDP receive failed");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            uint8_t *frame = ws2812_shm_begin(&in->shm);
+            if (ws2812_ddp_apply(&in->ddp, i, frame, led_count) > 0) ws2812_shm_publish(&in->shm);
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    const char *name = WS2812_SHM_DEFAULT;
+    int udp_port = -1;
+    mode_t mode = WS2812_SHM_MODE;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:m:u:")) != -1) {
+        switch (opt) {
+            case 'n': name = optarg; break;
+            case 'm': {
+                char *end;
+                long m = strtol(optarg, &end, 8);
+                if (*optarg == '\0' || *end != '\0' || m < 0 || m > 0777) { fprintf(stderr, "Bad mode %s (octal, e.g. 0660)\n", optarg); return 1; }
+                mode = (mode_t)m;
+                break;
+            }
+            case 'u': udp_port = atoi(optarg); break;
+            default: fprintf(stderr, "Usage: %s [-n shm-name] [-m mode] [-u udp-port]\n", argv[0]); return 1;
+        }
+    }
+
+    // Chain size and panel wiring (WS2812_LAYOUT), one 8x8 panel by default
+    struct ws2812_layout_config lc;
+    ws2812_layout_default(&lc);
+    ws2812_layout_from_env(&lc);
+    struct ws2812_layout layout;
+    if (ws2812_layout_init(&layout, &lc) < 0) { perror("Bad LED layout"); return 1; }
+
+    const char *path = ws2812_device_from_env(SPI_DEVICE);
+    if (strncmp(path, "shm:", 4) == 0) { fprintf(stderr, "ws2812d needs a real device, not %s\n", path); return 1; }
+
+    struct ws2812 dev;
+    if (ws2812_open(&dev, path, layout.count, ws2812_mode_from_env()) < 0) { perror("Can't open SPI device"); return 1; }
+
+    // Used until a pattern sends its own
+    struct ws2812_correction corr;
+    ws2812_correction_default(&corr);
+    ws2812_correction_from_env(&corr);
+    ws2812_set_correction(&dev, &corr);
+
+    struct ws2812_shm shm;
+    if (ws2812_shm_create(&shm, name, layout.count, layout.width, layout.height, mode) < 0) { perror("Can't create shared framebuffer"); return 1; }
+
+    // No SA_RESTART: a signal must break the futex wait
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    ws2812_sched_fifo_from_env();
+    ws2812_stats_from_env(&dev);     // encode/send timings for build/ws2812_stat (WS2812_STATS)
+
+    printf("ws2812d: %zu LEDs (%dx%d) on %s, frames from shm:%s\n",
+           layout.count, layout.width, layout.height, path, name);
+
+    // Started after the FIFO switch so the receiver inherits it
+    static struct ingest in;
+    pthread_t ingest_thread;
+    if (udp_port >= 0) {
+        if (ws2812_ddp_open(&in.ddp, udp_port) < 0) { perror("Can't open UDP port"); return 1; }
+        if (ws2812_shm_attach(&in.shm, name) < 0) { perror("Can't attach to shared framebuffer"); return 1; }
+        if (pthread_create(&ingest_thread, NULL, ingest_main, &in) != 0) { perror("Can't start UDP receiver"); return 1; }
+        printf("ws2812d: DDP on UDP port %d\n", udp_port ? udp_port : WS2812_DDP_PORT);
+    }
+
+    // Nothing to keep alive until a first frame has been encoded
+    int encoded = 0;
+    while (!g_stop) {
+        // Wake at least once per keepalive to resend an idle picture
+        const uint8_t *frame = ws2812_shm_acquire(&shm, WS2812_DEFAULT_KEEPALIVE_MS);
+
+        int on;
+        if (ws2812_shm_get_correction(&shm, &corr, &on)) {
+            ws2812_set_correction(&dev, on ? &corr : NULL);
+        }
+
+        size_t changed = 0;
+        if (frame != NULL) {
+            changed = ws2812_encode_frame_from(&dev, frame);
+            encoded = 1;
+            // The client may draw into it again while the frame is on the wire
+            ws2812_shm_release(&shm);
+        }
+
+        if (!encoded) continue;
+        if (!ws2812_should_flush(&dev, changed)) {
+            if (frame != NULL) {
+                dev.frames_skipped++;
+                if (dev.stats != NULL) atomic_fetch_add_explicit(&dev.stats->skipped, 1, memory_order_relaxed);
+            }
+            continue;
+        }
+        if (ws2812_flush(&dev) < 0 && errno != EINTR) perror("SPI transfer failed");
+    }
+
+    if (udp_port >= 0) {
+        pthread_join(ingest_thread, NULL);
+        printf("ws2812d: %llu DDP packets, %llu frames, %llu dropped\n",
+               (unsigned long long)in.ddp.stats.packets, (unsigned long long)in.ddp.stats.frames,
+               (unsigned long long)in.ddp.stats.bad);
+        ws2812_ddp_close(&in.ddp);
+        ws2812_shm_close(&in.shm);
+    }
+
+    // The shm object stays: a restarted daemon picks up the running pattern
+    ws2812_shm_close(&shm);
+    ws2812_close(&dev);
+    ws2812_layout_free(&layout);
+    return 0;
+}